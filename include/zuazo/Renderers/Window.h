@@ -4,6 +4,7 @@
 #include <zuazo/ZuazoBase.h>
 #include <zuazo/RendererBase.h>
 #include <zuazo/Video.h>
+#include <zuazo/Chrono.h>
 #include <zuazo/ScalingMode.h>
 #include <zuazo/ScalingFilter.h>
 #include <zuazo/Keyboard.h>
@@ -13,7 +14,9 @@
 #include <zuazo/Signal/ConsumerLayout.h>
 
 #include <tuple>
+#include <array>
 #include <vector>
+#include <memory>
 #include <mutex>
 
 namespace Zuazo::Renderers {
@@ -28,6 +31,7 @@ class Window final
 public:
 
 	class Monitor {
+		friend WindowImpl;
 	public:
 		struct Mode {
 			Math::Vec2i	size;
@@ -47,14 +51,88 @@ public:
 		std::string_view				getName() const;
 		Math::Vec2d						getPhysicalSize() const;
 		Math::Vec2i						getPosition() const;
-		const Mode&						getMode() const;
+		Mode							getMode() const;
 		Utils::BufferView<const Mode>	getModes() const;
 
 	private:
-		void*							m_handle;
+		std::shared_ptr<const void>		m_info;
 
 	};
 
+	class InputState {
+		friend WindowImpl;
+	public:
+		static constexpr size_t			KEY_WORD_COUNT = 6;
+
+		InputState();
+
+		KeyEvent						getKeyState(KeyboardKey key) const;
+		KeyEvent						getMouseButtonState(MouseKey but) const;
+		KeyModifiers					getKeyModifiers() const;
+		Math::Vec2d						getMousePosition() const;
+
+	private:
+		std::array<uint64_t, KEY_WORD_COUNT> m_keys;
+		uint32_t						m_mouseButtons;
+		KeyModifiers					m_modifiers;
+		Math::Vec2d						m_mousePosition;
+
+	};
+
+
+	enum class PresentMode {
+		immediate,
+		mailbox,
+		fifo,
+		fifoRelaxed
+	};
+
+	enum class LatencyProfile {
+		lowestLatency,
+		balanced,
+		smoothest
+	};
+
+	enum class AcquirePolicy {
+		skip,
+		retry
+	};
+
+	struct PresentTiming {
+		uint64_t	frameId;
+		TimePoint	presentTime;
+	};
+
+	struct DurationStatistics {
+		Duration	last;
+		Duration	average;
+		Duration	max;
+	};
+
+	struct GPUTimings {
+		DurationStatistics	renderPass;
+		DurationStatistics	layers;
+		DurationStatistics	finalize;
+	};
+
+	enum class FramePhase {
+		fenceWait,
+		acquire,
+		recording,
+		uniformFlush,
+		submit,
+		present
+	};
+
+	struct DurationHistogram {
+		static constexpr size_t BUCKET_COUNT = 40;
+
+		std::array<uint64_t, BUCKET_COUNT> buckets; //buckets[i] counts durations in [2^i, 2^(i+1)) ns
+		uint64_t					sampleCount;
+		Duration					total;
+		Duration					max;
+	};
+
 
 	using SizeCallback = std::function<void(Window&, Math::Vec2i)>;
 	using PositionCallback = std::function<void(Window&, Math::Vec2i)>;
@@ -69,6 +147,7 @@ public:
 	using MousePositionCallback = std::function<void(Window&, Math::Vec2d)>;
 	using MouseScrollCallback = std::function<void(Window&, Math::Vec2d)>;
 	using CursorEnterCallback = std::function<void(Window&, bool)>;
+	using PresentTimingCallback = std::function<void(Window&, PresentTiming)>;
 
 
 	struct Callbacks {
@@ -85,6 +164,7 @@ public:
 		MousePositionCallback		mousePositionCbk;
 		MouseScrollCallback			mouseScrollCbk;
 		CursorEnterCallback			cursorEnterCbk;
+		PresentTimingCallback		presentTimingCbk;
 	};
 
 
@@ -153,6 +233,52 @@ public:
 	void						setMonitor(const Monitor& mon, const Monitor::Mode* mode);
 	Monitor						getMonitor() const;
 
+	void						setLatencyProfile(LatencyProfile profile);
+	LatencyProfile				getLatencyProfile() const;
+	size_t						getExpectedFrameLatency() const;
+
+	void						setPresentMode(PresentMode mode);
+	PresentMode					getPresentMode() const;
+	std::vector<PresentMode>	getPresentModeCompatibility() const;
+
+	void						setMaxFramesInFlight(size_t count);
+	size_t						getMaxFramesInFlight() const;
+
+	void						setParallelRecording(bool ena);
+	bool						getParallelRecording() const;
+	void						setParallelRecording(const LayerBase& layer, bool ena);
+	bool						getParallelRecording(const LayerBase& layer) const;
+
+	void						setAcquireTimeout(Duration timeout);
+	Duration					getAcquireTimeout() const;
+	void						setAcquirePolicy(AcquirePolicy policy);
+	AcquirePolicy				getAcquirePolicy() const;
+	size_t						getSkippedFrameCount() const;
+	size_t						getLateFrameCount() const;
+	void						resetFrameCounters();
+
+	void						setFramePacing(bool ena);
+	bool						getFramePacing() const;
+	bool						getPresentTimingSupport() const; //Requires VK_GOOGLE_display_timing. Otherwise, timing and pacing are inert
+	Duration					getRefreshPeriod() const;
+	void						setPresentTimingCallback(PresentTimingCallback cbk);
+	const PresentTimingCallback& getPresentTimingCallback() const;
+
+	void						setTimestampQueries(bool ena);
+	bool						getTimestampQueries() const;
+	GPUTimings					getGPUTimings() const;
+	void						resetGPUTimings();
+
+	DurationHistogram			getFramePhaseHistogram(FramePhase phase) const;
+	void						resetFramePhaseHistograms();
+
+	void						setInputLatencyMeasurement(bool ena);
+	bool						getInputLatencyMeasurement() const;
+	DurationHistogram			getInputLatencyHistogram() const;
+	void						resetInputLatencyHistogram();
+
+
+	InputState					getInputState() const;
 
 	KeyEvent					getKeyState(KeyboardKey key) const;
 	void						setKeyboardCallback(KeyboardCallback cbk);
@@ -169,14 +295,26 @@ public:
 	void						setMousePositionCallback(MousePositionCallback cbk);
 	const MousePositionCallback& getMousePositionCallback() const;
 
+	void						setRawMouseMotion(bool ena);
+	bool						getRawMouseMotion() const;
+	bool						getRawMouseMotionSupport() const;
+	Math::Vec2d					consumeMouseMotion();
+
 	void						setMouseScrollCallback(MouseScrollCallback cbk);
 	const MouseScrollCallback& 	getMouseScrollCallback() const;
 
 	void						setCursorEnterCallback(CursorEnterCallback cbk);
 	const CursorEnterCallback& 	getCursorEnterCallback() const;
 
+	TimePoint					getEventTimestamp() const;
+
+	void						setInputCoalescing(bool ena);
+	bool						getInputCoalescing() const;
+	uint64_t					getCoalescedEventCount() const;
+	uint64_t					getEventOverflowCount() const;
+
 	static Monitor							getPrimaryMonitor();
-	static Utils::BufferView<const Monitor>	getMonitors();
+	static std::vector<Monitor>				getMonitors();
 
 	static const Monitor					NO_MONITOR;
 
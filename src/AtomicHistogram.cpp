@@ -0,0 +1,72 @@
+#include "AtomicHistogram.h"
+
+#include <cassert>
+
+namespace Zuazo {
+
+AtomicHistogram::AtomicHistogram() noexcept
+	: m_buckets()
+	, m_sampleCount(0)
+	, m_total(0)
+	, m_max(0)
+{
+	reset();
+}
+
+void AtomicHistogram::record(Duration value) noexcept {
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(value).count();
+
+	m_buckets[getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	m_sampleCount.fetch_add(1, std::memory_order_relaxed);
+	m_total.fetch_add(ns, std::memory_order_relaxed);
+
+	//Update the maximum. Usually there is a single writer, so it should not spin
+	auto max = m_max.load(std::memory_order_relaxed);
+	while(ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed));
+}
+
+void AtomicHistogram::reset() noexcept {
+	for(auto& bucket : m_buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+
+	m_sampleCount.store(0, std::memory_order_relaxed);
+	m_total.store(0, std::memory_order_relaxed);
+	m_max.store(0, std::memory_order_relaxed);
+}
+
+
+
+uint64_t AtomicHistogram::getBucket(size_t index) const noexcept {
+	assert(index < m_buckets.size());
+	return m_buckets[index].load(std::memory_order_relaxed);
+}
+
+uint64_t AtomicHistogram::getSampleCount() const noexcept {
+	return m_sampleCount.load(std::memory_order_relaxed);
+}
+
+Duration AtomicHistogram::getTotal() const noexcept {
+	return std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(m_total.load(std::memory_order_relaxed)));
+}
+
+Duration AtomicHistogram::getMax() const noexcept {
+	return std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(m_max.load(std::memory_order_relaxed)));
+}
+
+
+
+size_t AtomicHistogram::getBucketIndex(Duration value) noexcept {
+	//Bucket i holds the values in [2^i, 2^(i+1)) nanoseconds
+	auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(value).count();
+	size_t result = 0;
+
+	while(ns > 1 && result < BUCKET_COUNT - 1) {
+		ns >>= 1;
+		++result;
+	}
+
+	return result;
+}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <zuazo/Chrono.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Zuazo {
+
+class AtomicHistogram {
+public:
+	static constexpr size_t BUCKET_COUNT = 40;
+
+	AtomicHistogram() noexcept;
+	AtomicHistogram(const AtomicHistogram& other) = delete;
+	~AtomicHistogram() = default;
+
+	AtomicHistogram&					operator=(const AtomicHistogram& other) = delete;
+
+	void								record(Duration value) noexcept;
+	void								reset() noexcept;
+
+	uint64_t							getBucket(size_t index) const noexcept;
+	uint64_t							getSampleCount() const noexcept;
+	Duration							getTotal() const noexcept;
+	Duration							getMax() const noexcept;
+
+	static size_t						getBucketIndex(Duration value) noexcept;
+
+private:
+	std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets;
+	std::atomic<uint64_t>				m_sampleCount;
+	std::atomic<int64_t>				m_total;
+	std::atomic<int64_t>				m_max;
+
+};
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace Zuazo {
+
+/*
+ * Sequence lock protected value. Readers never block writers and they
+ * retry if a write happened while reading. The value is stored in 
+ * atomic words, so that concurrent reads and writes are not data races
+ */
+template<typename T>
+class AtomicSnapshot {
+	static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+public:
+	using Version = uint32_t;
+
+	explicit AtomicSnapshot(const T& value = T()) noexcept
+		: m_version(0)
+	{
+		storeWords(value);
+	}
+
+	AtomicSnapshot(const AtomicSnapshot& other) = delete;
+	~AtomicSnapshot() = default;
+
+	AtomicSnapshot& operator=(const AtomicSnapshot& other) = delete;
+
+	T load() const noexcept {
+		T result;
+		Version begin, end;
+
+		do {
+			begin = waitVersion();
+			result = loadWords();
+			std::atomic_thread_fence(std::memory_order_acquire);
+			end = m_version.load(std::memory_order_relaxed);
+		} while(begin != end);
+
+		return result;
+	}
+
+	void store(const T& value) noexcept {
+		const auto version = lock();
+		storeWords(value);
+		unlock(version);
+	}
+
+	template<typename Func>
+	void update(Func&& func) noexcept {
+		const auto version = lock();
+		T value = loadWords(); //Exclusive access, so it is consistent
+		std::forward<Func>(func)(value);
+		storeWords(value);
+		unlock(version);
+	}
+
+	Version getVersion() const noexcept {
+		return waitVersion();
+	}
+
+	bool compareAndStore(Version version, const T& value) noexcept {
+		//Only succeeds if nobody has written since the version was obtained
+		if(!m_version.compare_exchange_strong(version, version + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+			return false;
+		}
+
+		std::atomic_thread_fence(std::memory_order_release);
+		storeWords(value);
+		unlock(version);
+		return true;
+	}
+
+private:
+	static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+	std::atomic<Version>								m_version;
+	std::array<std::atomic<uint64_t>, WORD_COUNT>		m_words;
+
+	Version waitVersion() const noexcept {
+		Version result;
+
+		//Odd versions mean that a write is in progress
+		while((result = m_version.load(std::memory_order_acquire)) & 1) {
+			std::this_thread::yield();
+		}
+
+		return result;
+	}
+
+	Version lock() noexcept {
+		Version version;
+
+		do {
+			version = waitVersion();
+		} while(!m_version.compare_exchange_weak(version, version + 1, std::memory_order_acquire, std::memory_order_relaxed));
+
+		std::atomic_thread_fence(std::memory_order_release);
+		return version;
+	}
+
+	void unlock(Version version) noexcept {
+		m_version.store(version + 2, std::memory_order_release);
+	}
+
+	T loadWords() const noexcept {
+		std::array<uint64_t, WORD_COUNT> words;
+		for(size_t i = 0; i < WORD_COUNT; ++i) {
+			words[i] = m_words[i].load(std::memory_order_relaxed);
+		}
+
+		T result;
+		std::memcpy(&result, words.data(), sizeof(T));
+		return result;
+	}
+
+	void storeWords(const T& value) noexcept {
+		std::array<uint64_t, WORD_COUNT> words = {};
+		std::memcpy(words.data(), &value, sizeof(T));
+
+		for(size_t i = 0; i < WORD_COUNT; ++i) {
+			m_words[i].store(words[i], std::memory_order_relaxed);
+		}
+	}
+
+};
+
+}
@@ -1,7 +1,10 @@
 #include "Instance.h"
 
-#include <future>
+#include <exception>
+#include <optional>
+#include <string>
 #include <cassert>
+#include <algorithm>
 
 extern "C" {
 #define GLFW_INCLUDE_NONE //Don't include GL
@@ -36,6 +39,12 @@ static_assert(static_cast<int>(GLFW::KeyEvent::release) == GLFW_RELEASE, "RELEAS
 static_assert(static_cast<int>(GLFW::KeyEvent::press) == GLFW_PRESS, "PRESS event does not match");
 static_assert(static_cast<int>(GLFW::KeyEvent::repeat) == GLFW_REPEAT, "REPEAT event does not match");
 
+//Cursor mode
+static_assert(std::is_same<std::underlying_type<GLFW::CursorMode>::type, decltype(GLFW_CURSOR_NORMAL)>::value, "Types do not match");
+static_assert(static_cast<int>(GLFW::CursorMode::normal) == GLFW_CURSOR_NORMAL, "NORMAL cursor mode does not match");
+static_assert(static_cast<int>(GLFW::CursorMode::hidden) == GLFW_CURSOR_HIDDEN, "HIDDEN cursor mode does not match");
+static_assert(static_cast<int>(GLFW::CursorMode::disabled) == GLFW_CURSOR_DISABLED, "DISABLED cursor mode does not match");
+
 //Key modifiers
 static_assert(std::is_same<std::underlying_type<GLFW::KeyModifiers>::type, decltype(GLFW_MOD_SHIFT)>::value, "Types do not match");
 static_assert(static_cast<int>(GLFW::KeyModifiers::none) == 0, "NONE keyboard modifier bit does not match");
@@ -195,10 +204,6 @@ static Math::Vec2i getWindowPositionImpl(WindowHandle win) noexcept;
 static Math::Vec2i getWindowSizeImpl(WindowHandle win) noexcept;
 
 //Event stuff
-static MonitorCallback setMonitorCallbackImpl(MonitorCallback cbk) noexcept {
-	return reinterpret_cast<MonitorCallback>(glfwSetMonitorCallback(reinterpret_cast<GLFWmonitorfun>(cbk)));
-}
-
 static WindowPositionCallback setWindowPositionCallbackImpl(WindowHandle win, WindowPositionCallback cbk) noexcept {
 	return glfwSetWindowPosCallback(win, cbk);
 }
@@ -277,10 +282,6 @@ static void* getMonitorUserPointerImpl(MonitorHandle win) noexcept {
 
 
 //Monitor stuff
-static MonitorHandle getPrimaryMonitorImpl() noexcept {
-	return glfwGetPrimaryMonitor();
-}
-
 static Utils::BufferView<MonitorHandle> getMonitorsImpl() noexcept {
 	int cnt;
 	MonitorHandle* monitors = glfwGetMonitors(&cnt);
@@ -417,30 +418,40 @@ static bool isFocusedWindowImpl(WindowHandle win) noexcept {
 }
 
 
+static bool isSameVideoMode(const VideoMode& a, const VideoMode& b) noexcept {
+	return 	a.size == b.size && 
+			a.colorDepth == b.colorDepth && 
+			a.frameRate == b.frameRate ;
+}
+
 static void setWindowMonitorImpl(	WindowHandle win, 
 									MonitorHandle monitor,
 									const VideoMode* videoMode,
 									WindowGeometry* windowedGeometry ) noexcept
 {
-	const auto oldMonHandle = getWindowMonitorImpl(win);
+	assert(windowedGeometry);
+	//Don't query GLFW for the old monitor, as it leaves fullscreen by 
+	//itself when the monitor gets disconnected, before we are notified
+	const auto oldMonHandle = windowedGeometry->exclusiveMonitor;
+	const auto oldBorderlessHandle = windowedGeometry->borderlessMonitor;
 	const auto newMonHandle = monitor;
+	const bool wasWindowed = !oldMonHandle && !oldBorderlessHandle;
 
-	if(newMonHandle){
-		//A monitor has been specified
-		if(newMonHandle != oldMonHandle || videoMode != &(getVideoModeImpl(newMonHandle))) {
+	if(newMonHandle && videoMode){
+		//A monitor and a video mode have been specified. Modes are compared by 
+		//value, as the caller's copy may be located anywhere
+		if(newMonHandle != oldMonHandle || !isSameVideoMode(*videoMode, getVideoModeImpl(newMonHandle))) {
 			//Something has changed
-			if(!oldMonHandle){
+			if(wasWindowed){
 				//It was windowed. Save its state
-				assert(windowedGeometry);
-				*windowedGeometry = {
-					getWindowPositionImpl(win),
-					getWindowSizeImpl(win)
-				};
+				windowedGeometry->position = getWindowPositionImpl(win);
+				windowedGeometry->size = getWindowSizeImpl(win);
 			}
+			windowedGeometry->exclusiveMonitor = newMonHandle;
+			windowedGeometry->borderlessMonitor = nullptr;
 
 			//Set it fullscreen on the desired monitor
 			const Math::Vec2i pos = getMonitorPositionImpl(newMonHandle);
-			assert(videoMode);
 			glfwSetWindowMonitor(
 				win, 
 				newMonHandle, 
@@ -451,10 +462,51 @@ static void setWindowMonitorImpl(	WindowHandle win,
 				videoMode->frameRate
 			);
 		}
-	} else if(oldMonHandle) {
-		//It has become windowed
+	} else if(newMonHandle) {
+		//Only a monitor has been specified. Cover it without an exclusive
+		//mode set, as it blanks the outputs and it may take long
+		if(newMonHandle != oldBorderlessHandle) {
+			if(wasWindowed){
+				//It was windowed. Save its state
+				windowedGeometry->position = getWindowPositionImpl(win);
+				windowedGeometry->size = getWindowSizeImpl(win);
+			}
+			windowedGeometry->exclusiveMonitor = nullptr;
+			windowedGeometry->borderlessMonitor = newMonHandle;
+
+			if(oldMonHandle) {
+				//Leave exclusive mode first, as it restores the monitor's
+				//original video mode, which is the one to be covered
+				glfwSetWindowMonitor(
+					win,
+					static_cast<MonitorHandle>(nullptr),
+					windowedGeometry->position.x,
+					windowedGeometry->position.y,
+					windowedGeometry->size.x,
+					windowedGeometry->size.y,
+					GLFW_DONT_CARE
+				);
+			}
+
+			//Use an undecorated window with the same area as the monitor
+			const Math::Vec2i pos = getMonitorPositionImpl(newMonHandle);
+			const VideoMode currentMode = getVideoModeImpl(newMonHandle);
+			glfwSetWindowAttrib(win, GLFW_DECORATED, GLFW_FALSE);
+			glfwSetWindowMonitor(
+				win, 
+				static_cast<MonitorHandle>(nullptr), 
+				pos.x,
+				pos.y,
+				currentMode.size.x,
+				currentMode.size.y,
+				GLFW_DONT_CARE
+			);
+		}
+	} else if(!wasWindowed) {
+		//It has become windowed. Decorations are restored by the caller
 		assert(!newMonHandle);
-		assert(windowedGeometry);
+		windowedGeometry->exclusiveMonitor = nullptr;
+		windowedGeometry->borderlessMonitor = nullptr;
 		glfwSetWindowMonitor(
 			win, 
 			static_cast<MonitorHandle>(nullptr), 
@@ -552,6 +604,60 @@ static Math::Vec2d getMousePositionImpl(WindowHandle win) noexcept {
 	return result;
 }
 
+static void setCursorModeImpl(WindowHandle win, CursorMode mode) noexcept {
+	glfwSetInputMode(win, GLFW_CURSOR, static_cast<int>(mode));
+}
+
+static CursorMode getCursorModeImpl(WindowHandle win) noexcept {
+	return static_cast<CursorMode>(glfwGetInputMode(win, GLFW_CURSOR));
+}
+
+static void setRawMouseMotionImpl(WindowHandle win, bool ena) noexcept {
+	//Only available when supported. It only has effect when the cursor is disabled
+	if(glfwRawMouseMotionSupported()) {
+		glfwSetInputMode(win, GLFW_RAW_MOUSE_MOTION, ena);
+	}
+}
+
+static bool getRawMouseMotionImpl(WindowHandle win) noexcept {
+	return glfwGetInputMode(win, GLFW_RAW_MOUSE_MOTION);
+}
+
+static bool isRawMouseMotionSupportedImpl() noexcept {
+	return glfwRawMouseMotionSupported();
+}
+
+static WindowState applyWindowTransactionImpl(	WindowHandle win,
+												const WindowTransaction& transaction,
+												WindowGeometry* windowedGeometry ) noexcept
+{
+	//Apply all the requested changes. Monitor is set first, 
+	//as it may modify the position and the size
+	if(transaction.title) setWindowTitleImpl(win, *transaction.title);
+	if(transaction.monitor) setWindowMonitorImpl(win, transaction.monitor->monitor, transaction.monitor->videoMode, windowedGeometry);
+	if(transaction.position) setWindowPositionImpl(win, *transaction.position);
+	if(transaction.size) setWindowSizeImpl(win, *transaction.size);
+	if(transaction.opacity) setWindowOpacityImpl(win, *transaction.opacity);
+	if(transaction.resizeable) setWindowResizeableImpl(win, *transaction.resizeable);
+	if(transaction.decorated) setWindowDecoratedImpl(win, *transaction.decorated);
+	if(transaction.visibility) setWindowVisibilityImpl(win, *transaction.visibility);
+	if(transaction.cursorMode) setCursorModeImpl(win, *transaction.cursorMode);
+	if(transaction.rawMouseMotion) setRawMouseMotionImpl(win, *transaction.rawMouseMotion);
+
+	//Query the resulting state
+	return WindowState {
+		getWindowMonitorImpl(win),
+		getWindowPositionImpl(win),
+		getWindowSizeImpl(win),
+		getWindowResolutionImpl(win),
+		getWindowScaleImpl(win),
+		getMousePositionImpl(win),
+		isFocusedWindowImpl(win),
+		isIconifiedWindowImpl(win),
+		isMaximizedWindowImpl(win)
+	};
+}
+
 
 
 /*
@@ -563,21 +669,27 @@ Instance* Instance::s_singleton = nullptr;
 
 //Ctor/dtor
 Instance::Instance()
-	: m_mutex()
-	, m_tasks()
+	: m_tasks()
+	, m_initialization()
 	, m_exit(false)
-	, m_thread(&Instance::threadFunc, this)
+	, m_monitors(std::make_shared<const MonitorRegistry>())
+	, m_lastMonitorId(NO_MONITOR_ID)
+	, m_monitorCallback(nullptr)
+	, m_thread()
 {
-	//Wait initialization executing a no-op
-	execute([]{});
+	//The monitor callback needs to access the singleton, so it 
+	//must be set before the thread is started
+	s_singleton = this;
+	m_thread = std::thread(&Instance::threadFunc, this);
+
+	//Wait until GLFW is initialized
+	m_initialization.wait();
 }
 
 Instance::~Instance() {
 	//Raise the exit flag and signal it to the thread
-	std::unique_lock<std::mutex> lock(m_mutex);
-	m_exit = true;
+	m_exit.store(true, std::memory_order_release);
 	threadContinue();
-	lock.unlock();
 
 	//Wait thread finalization
 	assert(m_thread.joinable());
@@ -587,7 +699,8 @@ Instance::~Instance() {
 
 //Event stuff
 MonitorCallback Instance::setMonitorCallback(MonitorCallback cbk) const {
-	return execute(setMonitorCallbackImpl, cbk);
+	//Thread safe. It gets invoked by our own GLFW callback
+	return m_monitorCallback.exchange(cbk);
 }
 
 WindowPositionCallback Instance::setPositionCallback(WindowHandle win, WindowPositionCallback cbk) const {
@@ -660,42 +773,76 @@ void* Instance::getUserPointer(WindowHandle win) const {
 }
 
 void Instance::setUserPointer(MonitorHandle mon, void* usrPtr) const {
-	return execute(setMonitorUserPointerImpl, mon, usrPtr);
+	execute(
+		[this] (MonitorHandle mon, void* usrPtr) {
+			if(isMonitorConnected(mon)) setMonitorUserPointerImpl(mon, usrPtr);
+		},
+		mon, usrPtr
+	);
 }
 
 void* Instance::getUserPointer(MonitorHandle mon) const {
-	//Thread safe
-	return getMonitorUserPointerImpl(mon);
+	//The handle is only dereferenced on the GLFW thread, as it might get freed
+	return execute(
+		[this] (MonitorHandle mon) -> void* {
+			return isMonitorConnected(mon) ? getMonitorUserPointerImpl(mon) : nullptr;
+		},
+		mon
+	);
 }
 
 
 //Monitor stuff
 MonitorHandle Instance::getPrimaryMonitor() const {
-	return execute(getPrimaryMonitorImpl);
+	const auto monitors = getMonitors();
+	return monitors->empty() ? nullptr : monitors->front()->handle;
 }
 
-Utils::BufferView<MonitorHandle> Instance::getMonitors() const {
-	return execute(getMonitorsImpl);
+std::shared_ptr<const MonitorRegistry> Instance::getMonitors() const {
+	//Thread safe. The registry is never modified, but replaced as a whole
+	return std::atomic_load_explicit(&m_monitors, std::memory_order_acquire);
 }
 
-std::string_view Instance::getName(MonitorHandle mon) const {
-	return execute(getMonitorNameImpl, mon);
+void Instance::refreshMonitors() const {
+	//Positions and current modes may change without any notification
+	//(i.e. by other applications). Only from the GLFW thread, so that 
+	//readers never wait for it
+	assert(std::this_thread::get_id() == m_thread.get_id());
+	updateMonitors();
 }
 
-Math::Vec2i Instance::getPhysicalSize(MonitorHandle mon) const {
-	return execute(getMonitorPhysicalSizeImpl, mon);
+MonitorId Instance::getMonitorId(MonitorHandle mon) const {
+	const auto info = getMonitorInfo(mon);
+	return info ? info->id : NO_MONITOR_ID;
 }
 
-Math::Vec2i Instance::getPosition(MonitorHandle mon) const {
-	return execute(getMonitorPositionImpl, mon);
+MonitorHandle Instance::getMonitorHandle(MonitorId id) const {
+	const auto info = getMonitorInfo(id);
+	return info ? info->handle : nullptr;
 }
 
-const VideoMode& Instance::getVideoMode(MonitorHandle mon) const {
-	return execute(getVideoModeImpl, mon);
+std::shared_ptr<const MonitorInfo> Instance::getMonitorInfo(MonitorHandle mon) const {
+	const auto monitors = getMonitors();
+	const auto ite = std::find_if(
+		monitors->cbegin(), monitors->cend(),
+		[mon] (const std::shared_ptr<const MonitorInfo>& info) -> bool {
+			return info->handle == mon;
+		}
+	);
+
+	return (ite != monitors->cend()) ? *ite : nullptr;
 }
 
-Utils::BufferView<const VideoMode> Instance::getVideoModes(MonitorHandle mon) const {
-	return execute(getVideoModesImpl, mon);
+std::shared_ptr<const MonitorInfo> Instance::getMonitorInfo(MonitorId id) const {
+	const auto monitors = getMonitors();
+	const auto ite = std::find_if(
+		monitors->cbegin(), monitors->cend(),
+		[id] (const std::shared_ptr<const MonitorInfo>& info) -> bool {
+			return info->id == id;
+		}
+	);
+
+	return (ite != monitors->cend()) ? *ite : nullptr;
 }
 
 
@@ -706,21 +853,41 @@ WindowHandle Instance::createWindow(Math::Vec2i size,
 									const WindowCallbacks& callbacks,
 									void* usrPtr ) const
 {
-	return execute(createWindowImpl, size, name, mon, callbacks, usrPtr);
+	return execute(
+		[this] (Math::Vec2i size, const char* name, MonitorHandle mon, const WindowCallbacks& callbacks, void* usrPtr) {
+			//Fall back to windowed mode if the monitor has been disconnected meanwhile
+			return createWindowImpl(size, name, isMonitorConnected(mon) ? mon : nullptr, callbacks, usrPtr);
+		},
+		size, name, mon, callbacks, usrPtr
+	);
 }
 
 void Instance::destroyWindow(WindowHandle win) const {
-	execute(destroyWindowImpl, win);
+	execute(
+		[this] (WindowHandle win) {
+			//Fullscreen windows restore the video mode of their monitor
+			const bool fullscreen = getWindowMonitorImpl(win) != nullptr;
+			destroyWindowImpl(win);
+			if(fullscreen) updateMonitors();
+		},
+		win
+	);
 }
 
 void Instance::setTitle(WindowHandle win, const char* title) const {
-	execute(setWindowTitleImpl, win, title);
+	//Copy the title, as the caller's string may not outlive the call
+	executeAsync(
+		[] (WindowHandle win, const std::string& title) {
+			setWindowTitleImpl(win, title.c_str());
+		},
+		win, std::string(title)
+	);
 }
 
 
 
 void Instance::restore(WindowHandle win) const {
-	execute(restoreWindowImpl, win);
+	executeAsync(restoreWindowImpl, win);
 }
 
 bool Instance::shouldClose(WindowHandle win) const {
@@ -730,7 +897,7 @@ bool Instance::shouldClose(WindowHandle win) const {
 
 
 void Instance::iconify(WindowHandle win) const {
-	execute(iconifyWindowImpl, win);
+	executeAsync(iconifyWindowImpl, win);
 }
 
 bool Instance::isIconified(WindowHandle win) const {
@@ -738,7 +905,7 @@ bool Instance::isIconified(WindowHandle win) const {
 }
 
 void Instance::maximize(WindowHandle win) const {
-	execute(maximizeWindowImpl, win);
+	executeAsync(maximizeWindowImpl, win);
 }
 
 bool Instance::isMaximized(WindowHandle win) const {
@@ -746,7 +913,7 @@ bool Instance::isMaximized(WindowHandle win) const {
 }
 
 void Instance::focus(WindowHandle win) const {
-	execute(focusWindowImpl, win);
+	executeAsync(focusWindowImpl, win);
 }
 
 bool Instance::isFocused(WindowHandle win) const {
@@ -759,7 +926,19 @@ void Instance::setMonitor(	WindowHandle win,
 							const VideoMode* videoMode,
 							WindowGeometry* geometry ) const
 {
-	execute(setWindowMonitorImpl, win, monitor, videoMode, geometry);
+	execute(
+		[this] (WindowHandle win, MonitorHandle monitor, const VideoMode* videoMode, WindowGeometry* geometry) {
+			if(isMonitorConnected(monitor)) {
+				setWindowMonitorImpl(win, monitor, videoMode, geometry);
+			} else {
+				setWindowMonitorImpl(win, nullptr, nullptr, geometry);
+			}
+
+			//The current video mode may have changed
+			updateMonitors();
+		},
+		win, monitor, videoMode, geometry
+	);
 }
 
 MonitorHandle Instance::getMonitor(WindowHandle win) const {
@@ -769,7 +948,7 @@ MonitorHandle Instance::getMonitor(WindowHandle win) const {
 void Instance::setPosition(	WindowHandle win, 
 							Math::Vec2i pos) const
 {
-	execute(setWindowPositionImpl, win, pos);
+	executeAsync(setWindowPositionImpl, win, pos);
 }
 
 Math::Vec2i Instance::getPosition(WindowHandle win) const {
@@ -779,7 +958,7 @@ Math::Vec2i Instance::getPosition(WindowHandle win) const {
 void Instance::setSize(	WindowHandle win, 
 						Math::Vec2i size ) const
 {
-	execute(setWindowSizeImpl, win, size);
+	executeAsync(setWindowSizeImpl, win, size);
 }
 
 Math::Vec2i Instance::getSize(WindowHandle win) const {
@@ -789,7 +968,7 @@ Math::Vec2i Instance::getSize(WindowHandle win) const {
 void Instance::setOpacity(	WindowHandle win,
 							float opa ) const
 {
-	execute(setWindowOpacityImpl, win, opa);
+	executeAsync(setWindowOpacityImpl, win, opa);
 }
 
 float Instance::getOpacity(WindowHandle win) const {
@@ -807,7 +986,7 @@ Math::Vec2f Instance::getScale(WindowHandle win) const {
 void Instance::setDecorated(WindowHandle win,
 							bool deco ) const
 {
-	execute(setWindowDecoratedImpl, win, deco);
+	executeAsync(setWindowDecoratedImpl, win, deco);
 }
 
 bool Instance::getDecorated(WindowHandle win) const {
@@ -817,7 +996,7 @@ bool Instance::getDecorated(WindowHandle win) const {
 void Instance::setResizeable(	WindowHandle win, 
 								bool resizeable ) const
 {
-	execute(setWindowResizeableImpl, win, resizeable);
+	executeAsync(setWindowResizeableImpl, win, resizeable);
 }
 
 bool Instance::getResizeable(WindowHandle win) const {
@@ -827,7 +1006,7 @@ bool Instance::getResizeable(WindowHandle win) const {
 void Instance::setVisibility(	WindowHandle win, 
 								bool visibility) const 
 {
-	execute(setWindowVisibilityImpl, win, visibility);
+	executeAsync(setWindowVisibilityImpl, win, visibility);
 }
 
 bool Instance::getVisibility(WindowHandle win) const {
@@ -857,6 +1036,55 @@ std::string_view Instance::getKeyName(KeyboardKey key, int scancode) const {
 	}	
 }
 
+void Instance::setCursorMode(	WindowHandle win,
+								CursorMode mode ) const
+{
+	executeAsync(setCursorModeImpl, win, mode);
+}
+
+CursorMode Instance::getCursorMode(WindowHandle win) const {
+	return execute(getCursorModeImpl, win);
+}
+
+void Instance::setRawMouseMotion(	WindowHandle win,
+									bool ena ) const
+{
+	executeAsync(setRawMouseMotionImpl, win, ena);
+}
+
+bool Instance::getRawMouseMotion(WindowHandle win) const {
+	return execute(getRawMouseMotionImpl, win);
+}
+
+bool Instance::isRawMouseMotionSupported() const {
+	return execute(isRawMouseMotionSupportedImpl);
+}
+
+WindowState Instance::applyTransaction(	WindowHandle win,
+										const WindowTransaction& transaction,
+										WindowGeometry* geometry ) const
+{
+	//All the changes and queries are performed on a single round-trip
+	return execute(
+		[this] (WindowHandle win, const WindowTransaction& transaction, WindowGeometry* geometry) {
+			WindowState result;
+			if(transaction.monitor && !isMonitorConnected(transaction.monitor->monitor)) {
+				//Fall back to windowed mode if the monitor has been disconnected meanwhile
+				auto windowed = transaction;
+				windowed.monitor = WindowMonitorChange{ nullptr, nullptr };
+				result = applyWindowTransactionImpl(win, windowed, geometry);
+			} else {
+				result = applyWindowTransactionImpl(win, transaction, geometry);
+			}
+
+			//The current video mode may have changed
+			if(transaction.monitor) updateMonitors();
+			return result;
+		},
+		win, transaction, geometry
+	);
+}
+
 std::vector<vk::ExtensionProperties> Instance::getRequiredVulkanInstanceExtensions() const {
 	//Thread safe
 	uint32_t glfwExtensionCount;
@@ -913,6 +1141,7 @@ vk::SurfaceKHR Instance::createSurface(	WindowHandle win,
 void Instance::initialize() {
 	assert(!s_singleton);
 	s_singleton = new Instance();
+	assert(s_singleton);
 }
 
 void Instance::terminate() {
@@ -936,36 +1165,104 @@ typename std::invoke_result<Func, Args...>::type Instance::execute(Func&& func,
 		//We are on the main thread. Simply execute it
 		return std::forward<Func>(func)(std::forward<Args>(args)...); 
 	}else {
-		//Create a packaged task to pass it to the main thread
-		std::packaged_task<Ret()> task(std::bind(std::forward<Func>(func), std::forward<Args>(args)...));
+		//Result is written in place, so that nothing is allocated. 
+		//References are stored as pointers
+		using Result = std::conditional_t<
+			std::is_void<Ret>::value,
+			bool,
+			std::conditional_t<
+				std::is_reference<Ret>::value,
+				std::add_pointer_t<std::remove_reference_t<Ret>>,
+				Ret
+			>
+		>;
+
+		Completion completion;
+		std::optional<Result> result;
+		std::exception_ptr exception;
+
+		auto invoke = [&] {
+			try {
+				if constexpr (std::is_void<Ret>::value) {
+					std::forward<Func>(func)(std::forward<Args>(args)...);
+					result.emplace(true);
+				} else if constexpr (std::is_reference<Ret>::value) {
+					result.emplace(&(std::forward<Func>(func)(std::forward<Args>(args)...)));
+				} else {
+					result.emplace(std::forward<Func>(func)(std::forward<Args>(args)...));
+				}
+			} catch(...) {
+				exception = std::current_exception();
+			}
+
+			completion.complete();
+		};
 
-		//Pass the packaged task to the main thread and signal it
-		std::unique_lock<std::mutex> lock(m_mutex);
-		m_tasks.push_back(std::ref(task));
+		//Only a reference to the stack frame is enqueued, as we will 
+		//wait until it completes
+		auto task = [&invoke] () noexcept { invoke(); };
+		threadPush(task);
+		completion.wait();
+
+		if(exception) {
+			std::rethrow_exception(exception);
+		}
+
+		assert(result);
+		if constexpr (std::is_void<Ret>::value) {
+			return;
+		} else if constexpr (std::is_reference<Ret>::value) {
+			return static_cast<Ret>(**result);
+		} else {
+			return std::move(*result);
+		}
+	}
+}
+
+template<typename Func, typename... Args>
+void Instance::executeAsync(Func&& func, Args&&... args) const {
+	if(std::this_thread::get_id() == m_thread.get_id()){
+		//We are on the main thread. Simply execute it
+		std::forward<Func>(func)(std::forward<Args>(args)...); 
+	}else {
+		//Arguments are copied, as the caller does not wait. Tasks are executed
+		//in order, so subsequent blocking calls will observe its effects
+		auto task = [bound = std::bind(std::forward<Func>(func), std::forward<Args>(args)...)] () mutable noexcept { 
+			bound(); 
+		};
+		threadPush(task);
+	}
+}
+
+template<typename Task>
+void Instance::threadPush(Task& task) const {
+	while(!m_tasks.tryPush(task)) {
+		//Queue is full. Let the main thread consume some tasks
 		threadContinue();
-		
-		//Wait until execution is complete
-		lock.unlock();
-		return task.get_future().get();
+		std::this_thread::yield();
 	}
+
+	threadContinue();
 }
 
 void Instance::threadFunc() {
-	std::unique_lock<std::mutex> lock(m_mutex);
-
 	glfwInit();
+	glfwSetMonitorCallback(monitorCallback);
+	updateMonitors();
+	m_initialization.complete();
 
-	while(m_exit == false){
+	while(m_exit.load(std::memory_order_acquire) == false){
 		//Wait until notified
-		threadWaitEvents(lock);
+		threadWaitEvents();
 
-		//Invoke all pending tasks
-		for(const auto& task : m_tasks) {
-			task();
-		}
-		m_tasks.clear();
+		//Invoke all pending tasks. No lock is held, so tasks and 
+		//callbacks may freely enqueue new ones
+		while(m_tasks.pop());
 	}
 
+	//Flush the remaining tasks before terminating
+	while(m_tasks.pop());
+
 	glfwTerminate();
 }
 
@@ -973,12 +1270,78 @@ void Instance::threadContinue() const {
 	glfwPostEmptyEvent();
 }
 
-void Instance::threadWaitEvents(std::unique_lock<std::mutex>& lock) const {
-	assert(lock.owns_lock());
-	lock.unlock();
+void Instance::threadWaitEvents() const {
 	glfwWaitEvents();
-	lock.lock();
 }
 
 
+bool Instance::isMonitorConnected(MonitorHandle mon) const {
+	//When called from the GLFW thread the registry is always up to date
+	return mon && getMonitorId(mon) != NO_MONITOR_ID;
+}
+
+void Instance::updateMonitors() const {
+	//Only called from the GLFW thread. Monitors which were already 
+	//present keep their identifiers. All the properties are queried
+	//now, so that readers never need to access GLFW
+	const auto handles = getMonitorsImpl();
+	const auto oldMonitors = getMonitors();
+	bool changed = oldMonitors->size() != handles.size();
+
+	auto monitors = std::make_shared<MonitorRegistry>();
+	monitors->reserve(handles.size());
+	for(const auto handle : handles) {
+		const auto old = getMonitorInfo(handle);
+		const auto position = getMonitorPositionImpl(handle);
+		const auto& videoMode = getVideoModeImpl(handle);
+
+		if(old && old->position == position && isSameVideoMode(old->videoMode, videoMode)) {
+			//Nothing has changed, reuse it
+			changed |= monitors->size() >= oldMonitors->size() || (*oldMonitors)[monitors->size()] != old;
+			monitors->push_back(old);
+			continue;
+		}
+
+		changed = true;
+
+		const auto videoModes = getVideoModesImpl(handle);
+		monitors->push_back(std::make_shared<const MonitorInfo>(MonitorInfo{
+			handle,
+			old ? old->id : ++m_lastMonitorId,
+			std::string(getMonitorNameImpl(handle)),
+			getMonitorPhysicalSizeImpl(handle),
+			position,
+			videoMode,
+			std::vector<VideoMode>(videoModes.cbegin(), videoModes.cend())
+		}));
+	}
+
+	//Avoid replacing the registry when polling without any change
+	if(!changed) {
+		return;
+	}
+
+	std::atomic_store_explicit(
+		&m_monitors, 
+		std::shared_ptr<const MonitorRegistry>(std::move(monitors)),
+		std::memory_order_release
+	);
+}
+
+void Instance::monitorCallback(MonitorHandle mon, int event) {
+	auto& instance = get();
+
+	//A disconnected monitor needs to be identified before it gets 
+	//removed from the registry, a connected one after adding it.
+	//Note that GLFW frees disconnected monitors after returning
+	MonitorId id = instance.getMonitorId(mon);
+	instance.updateMonitors();
+	if(id == NO_MONITOR_ID) id = instance.getMonitorId(mon);
+
+	const auto cbk = instance.m_monitorCallback.load();
+	if(cbk) {
+		cbk(mon, id, static_cast<MonitorEvent>(event));
+	}
+}
+
 }
\ No newline at end of file
@@ -13,18 +13,27 @@ struct GLFWmonitor;
 #include <zuazo/Utils/Bit.h>
 #include <zuazo/Math/Vector.h>
 
+#include "TaskQueue.h"
+
 #include <chrono>
 #include <thread>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <vector>
+#include <memory>
 #include <functional>
+#include <optional>
+#include <string>
 #include <string_view>
 
 namespace Zuazo::GLFW {
 
 using WindowHandle = GLFWwindow*;
 using MonitorHandle = GLFWmonitor*;
+using MonitorId = uint64_t;
+
+constexpr MonitorId NO_MONITOR_ID = 0;
 
 enum class MonitorEvent : int {
 	connected = 0x00040001,
@@ -37,6 +46,12 @@ enum class KeyEvent : int {
 	repeat			= 2
 };
 
+enum class CursorMode : int {
+	normal			= 0x00034001,
+	hidden			= 0x00034002,
+	disabled		= 0x00034003
+};
+
 enum class KeyModifiers : int {
 	none			= 0,
 	shift 			= Utils::bit(0),
@@ -194,13 +209,57 @@ struct VideoMode {
 	int			frameRate;
 };
 
+struct MonitorInfo {
+	MonitorHandle			handle;
+	MonitorId				id;
+	std::string				name;
+	Math::Vec2i				physicalSize;
+	Math::Vec2i				position; //May change while connected. Only as recent as the registry
+	VideoMode				videoMode; //May change while connected. Only as recent as the registry
+	std::vector<VideoMode>	videoModes;
+};
+
+using MonitorRegistry = std::vector<std::shared_ptr<const MonitorInfo>>; //Primary monitor comes first
+
 struct WindowGeometry {
-	Math::Vec2i	position;
-	Math::Vec2i	size;
+	Math::Vec2i		position;
+	Math::Vec2i		size;
+	MonitorHandle	exclusiveMonitor; //Monitor used by the window when fullscreen
+	MonitorHandle	borderlessMonitor; //Monitor covered by the window when borderless
 };
 
+struct WindowMonitorChange {
+	MonitorHandle		monitor;
+	const VideoMode*	videoMode;
+};
 
-typedef void(*MonitorCallback) (MonitorHandle, MonitorEvent);
+struct WindowTransaction {
+	std::optional<const char*>			title;
+	std::optional<WindowMonitorChange>	monitor;
+	std::optional<Math::Vec2i>			position;
+	std::optional<Math::Vec2i>			size;
+	std::optional<float>				opacity;
+	std::optional<bool>					resizeable;
+	std::optional<bool>					decorated;
+	std::optional<bool>					visibility;
+	std::optional<CursorMode>			cursorMode;
+	std::optional<bool>					rawMouseMotion;
+};
+
+struct WindowState {
+	MonitorHandle	monitor;
+	Math::Vec2i		position;
+	Math::Vec2i		size;
+	Resolution		resolution;
+	Math::Vec2f		scale;
+	Math::Vec2d		mousePosition;
+	bool			focused;
+	bool			iconified;
+	bool			maximized;
+};
+
+
+typedef void(*MonitorCallback) (MonitorHandle, MonitorId, MonitorEvent);
 typedef void(*WindowPositionCallback) (WindowHandle, int, int);
 typedef void(*WindowSizeCallback) (WindowHandle, int, int);
 typedef void(*WindowCloseCallback) (WindowHandle);
@@ -266,12 +325,12 @@ public:
 
 	//Monitor stuff
 	MonitorHandle 										getPrimaryMonitor() const;
-	Utils::BufferView<MonitorHandle> 					getMonitors() const;
-	std::string_view 									getName(MonitorHandle mon) const;
-	Math::Vec2i 										getPhysicalSize(MonitorHandle mon) const;
-	Math::Vec2i 										getPosition(MonitorHandle mon) const;
-	const VideoMode&									getVideoMode(MonitorHandle mon) const;
-	Utils::BufferView<const VideoMode>					getVideoModes(MonitorHandle mon) const;
+	std::shared_ptr<const MonitorRegistry>				getMonitors() const;
+	void												refreshMonitors() const;
+	MonitorId											getMonitorId(MonitorHandle mon) const;
+	MonitorHandle										getMonitorHandle(MonitorId id) const;
+	std::shared_ptr<const MonitorInfo>					getMonitorInfo(MonitorHandle mon) const;
+	std::shared_ptr<const MonitorInfo>					getMonitorInfo(MonitorId id) const;
 
 	//Window stuff
 	WindowHandle 										createWindow(	Math::Vec2i size, 
@@ -334,6 +393,19 @@ public:
 	Math::Vec2d 										getMousePosition(WindowHandle win) const;
 	std::string_view									getKeyName(KeyboardKey key, int scancode) const;
 
+	void												setCursorMode(	WindowHandle win,
+																		CursorMode mode ) const;
+	CursorMode											getCursorMode(WindowHandle win) const;
+
+	void												setRawMouseMotion(	WindowHandle win,
+																			bool ena ) const;
+	bool												getRawMouseMotion(WindowHandle win) const;
+	bool												isRawMouseMotionSupported() const;
+
+	WindowState											applyTransaction(	WindowHandle win,
+																			const WindowTransaction& transaction,
+																			WindowGeometry* geometry ) const;
+
 	//Vulkan stuff
 	std::vector<vk::ExtensionProperties> 				getRequiredVulkanInstanceExtensions() const;
 	std::vector<vk::ExtensionProperties> 				getRequiredVulkanDeviceExtensions() const;
@@ -351,16 +423,27 @@ private:
 	Instance();
 	Instance(const Instance& other) = delete;
 
-	mutable std::mutex									m_mutex;
-	mutable std::vector<std::function<void(void)>>		m_tasks;
-	bool												m_exit;
+	mutable TaskQueue									m_tasks;
+	Completion											m_initialization;
+	std::atomic<bool>									m_exit;
+	mutable std::shared_ptr<const MonitorRegistry>		m_monitors;
+	mutable MonitorId									m_lastMonitorId;
+	mutable std::atomic<MonitorCallback>				m_monitorCallback;
 	std::thread											m_thread;
 
 	template<typename Func, typename... Args>
 	typename std::invoke_result<Func, Args...>::type	execute(Func&& func, Args&&... args) const;
+	template<typename Func, typename... Args>
+	void												executeAsync(Func&& func, Args&&... args) const;
+	template<typename Task>
+	void												threadPush(Task& task) const;
 	void												threadFunc();
 	void												threadContinue() const;
-	void												threadWaitEvents(std::unique_lock<std::mutex>& lock) const;
+	void												threadWaitEvents() const;
+
+	bool												isMonitorConnected(MonitorHandle mon) const;
+	void												updateMonitors() const;
+	static void											monitorCallback(MonitorHandle mon, int event);
 
 	static Instance*									s_singleton;
 
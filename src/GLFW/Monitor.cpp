@@ -12,6 +12,10 @@ Monitor::operator MonitorHandle() noexcept {
 	return m_monitor;
 }
 
+MonitorId Monitor::getId() const {
+	return Instance::get().getMonitorId(m_monitor);
+}
+
 
 void Monitor::setUserPointer(void* ptr) {
 	Instance::get().setUserPointer(m_monitor, ptr);
@@ -22,40 +26,31 @@ void* Monitor::getUserPointer() const {
 }
 
 
-std::string_view Monitor::getName() const {
-	return Instance::get().getName(m_monitor);
+std::shared_ptr<const MonitorInfo> Monitor::getInfo() const {
+	//Served from the monitor registry
+	return Instance::get().getMonitorInfo(m_monitor);
 }
 
-Math::Vec2i Monitor::getPhysicalSize() const {
-	return Instance::get().getPhysicalSize(m_monitor);
-}
 
-Math::Vec2i Monitor::getPosition() const {
-	return Instance::get().getPosition(m_monitor);
+Monitor Monitor::getPrimaryMonitor() {
+	const auto monitor = Instance::get().getPrimaryMonitor();
+	return reinterpret_cast<const Monitor&>(monitor);
 }
 
-const VideoMode& Monitor::getVideoMode() const {
-	return Instance::get().getVideoMode(m_monitor);
+std::shared_ptr<const MonitorRegistry> Monitor::getMonitors() {
+	return Instance::get().getMonitors();
 }
 
-Utils::BufferView<const VideoMode> Monitor::getVideoModes() const {
-	return Instance::get().getVideoModes(m_monitor);
+void Monitor::refreshMonitors() {
+	Instance::get().refreshMonitors();
 }
 
-
-Monitor Monitor::getPrimaryMonitor() {
-	const auto monitor = Instance::get().getPrimaryMonitor();
-	return reinterpret_cast<const Monitor&>(monitor);
+Monitor Monitor::fromId(MonitorId id) {
+	return Monitor(Instance::get().getMonitorHandle(id));
 }
 
-Utils::BufferView<Monitor> Monitor::getMonitors() {
-	const auto monitors = Instance::get().getMonitors();
-
-	static_assert(sizeof(MonitorHandle) == sizeof(Monitor), "Sizes must match");
-	return Utils::BufferView<Monitor>(
-		reinterpret_cast<Monitor*>(monitors.data()),
-		monitors.size()
-	);
+std::shared_ptr<const MonitorInfo> Monitor::getInfo(MonitorId id) {
+	return Instance::get().getMonitorInfo(id);
 }
 
 MonitorCallback Monitor::setMonitorCallback(MonitorCallback cbk) {
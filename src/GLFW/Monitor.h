@@ -14,17 +14,18 @@ public:
 
 	operator MonitorHandle() noexcept;
 
+	MonitorId							getId() const;
+
 	void								setUserPointer(void* ptr);
 	void*								getUserPointer() const;
 
-	std::string_view 					getName() const;
-	Math::Vec2i 						getPhysicalSize() const;
-	Math::Vec2i 						getPosition() const;
-	const VideoMode&					getVideoMode() const;
-	Utils::BufferView<const VideoMode>	getVideoModes() const;
+	std::shared_ptr<const MonitorInfo>	getInfo() const;
 
 	static Monitor						getPrimaryMonitor();
-	static Utils::BufferView<Monitor>	getMonitors();
+	static std::shared_ptr<const MonitorRegistry> getMonitors();
+	static void							refreshMonitors();
+	static Monitor						fromId(MonitorId id);
+	static std::shared_ptr<const MonitorInfo> getInfo(MonitorId id);
 	static MonitorCallback				setMonitorCallback(MonitorCallback cbk);
 	
 private:
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace Zuazo::GLFW {
+
+/*
+ * Bounded multiple producer, single consumer queue. Tasks are stored
+ * inline in preallocated slots, so pushing and executing does not 
+ * allocate. Tasks must not throw.
+ */
+class TaskQueue {
+public:
+	static constexpr size_t CAPACITY = 256; //Must be a power of 2
+	static constexpr size_t STORAGE_SIZE = 64;
+
+	TaskQueue() noexcept
+		: m_slots()
+		, m_enqueuePosition(0)
+		, m_dequeuePosition(0)
+	{
+		for(size_t i = 0; i < m_slots.size(); ++i) {
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+			m_slots[i].invoke = nullptr;
+		}
+	}
+
+	TaskQueue(const TaskQueue& other) = delete;
+
+	~TaskQueue() {
+		//Destroy the remaining tasks without invoking them
+		while(pop(false));
+	}
+
+	TaskQueue& operator=(const TaskQueue& other) = delete;
+
+	//Thread safe. Moves from func only if it succeeds
+	template<typename Func>
+	bool tryPush(Func& func) {
+		using Task = std::decay_t<Func>;
+		static_assert(sizeof(Task) <= STORAGE_SIZE, "Task is too big to be stored inline");
+		static_assert(alignof(Task) <= alignof(std::max_align_t), "Task is overaligned");
+
+		//Claim a slot
+		Slot* slot;
+		auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+		while(true) {
+			slot = &m_slots[position & MASK];
+			const auto sequence = slot->sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+			if(difference == 0) {
+				//Slot is free. Try to claim it
+				if(m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if(difference < 0) {
+				return false; //Full
+			} else {
+				//Someone else has claimed it
+				position = m_enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		//Construct the task in place and publish it. Slot needs to be
+		//published even if construction fails, as it has been claimed
+		try {
+			new (slot->storage) Task(std::move(func));
+			slot->invoke = invokeTask<Task>;
+		} catch(...) {
+			slot->invoke = nullptr;
+			slot->sequence.store(position + 1, std::memory_order_release);
+			throw;
+		}
+
+		slot->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	//Only from the consumer thread
+	bool pop(bool execute = true) noexcept {
+		const auto position = m_dequeuePosition;
+		auto& slot = m_slots[position & MASK];
+		const auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+		if(sequence != position + 1) {
+			return false; //Empty or not published yet
+		}
+
+		//Invoke and destroy it
+		m_dequeuePosition = position + 1;
+		if(slot.invoke) {
+			slot.invoke(slot.storage, execute);
+		}
+
+		//Release the slot for the next round
+		slot.sequence.store(position + CAPACITY, std::memory_order_release);
+		return true;
+	}
+
+private:
+	static constexpr size_t MASK = CAPACITY - 1;
+	static_assert((CAPACITY & MASK) == 0, "Capacity must be a power of 2");
+
+	using Invoker = void(*)(void*, bool);
+
+	struct Slot {
+		std::atomic<size_t>								sequence;
+		Invoker											invoke;
+		alignas(std::max_align_t) unsigned char			storage[STORAGE_SIZE];
+	};
+
+	std::array<Slot, CAPACITY>							m_slots;
+	alignas(64) std::atomic<size_t>						m_enqueuePosition;
+	alignas(64) size_t									m_dequeuePosition;
+
+	template<typename Task>
+	static void invokeTask(void* storage, bool execute) noexcept {
+		auto& task = *std::launder(reinterpret_cast<Task*>(storage));
+		if(execute) {
+			task();
+		}
+		task.~Task();
+	}
+
+};
+
+
+
+/*
+ * One-shot completion flag. Waiters spin for a short while, as 
+ * most of the tasks are short, and then they sleep.
+ */
+class Completion {
+public:
+	Completion() noexcept
+		: m_mutex()
+		, m_condition()
+		, m_done(false)
+	{
+	}
+
+	Completion(const Completion& other) = delete;
+	~Completion() = default;
+
+	Completion& operator=(const Completion& other) = delete;
+
+	void complete() noexcept {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_done.store(true, std::memory_order_release);
+		m_condition.notify_all();
+	}
+
+	void wait() noexcept {
+		constexpr size_t SPIN_COUNT = 1024;
+
+		for(size_t i = 0; i < SPIN_COUNT && !m_done.load(std::memory_order_acquire); ++i);
+
+		//Always lock, so that complete() has returned before this object can be destroyed
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this] { return m_done.load(std::memory_order_relaxed); });
+	}
+
+private:
+	std::mutex											m_mutex;
+	std::condition_variable								m_condition;
+	std::atomic<bool>									m_done;
+
+};
+
+}
@@ -15,6 +15,12 @@ Window::Window(	Math::Vec2i size,
 				void* usrPtr )
 	: Window(Instance::get().createWindow(size, name, reinterpret_cast<const MonitorHandle&>(mon), callbacks, usrPtr))
 {
+	//Windows created on a monitor are fullscreen. Leaving it restores the requested size
+	const auto monitor = reinterpret_cast<const MonitorHandle&>(mon);
+	if(monitor) {
+		m_windowedGeometry.size = size;
+		m_windowedGeometry.exclusiveMonitor = monitor;
+	}
 }
 
 Window::Window(Window&& other)
@@ -252,14 +258,39 @@ Math::Vec2d Window::getMousePosition() const {
 	return Instance::get().getMousePosition(m_window);
 }
 
+
+void Window::setCursorMode(CursorMode mode) {
+	Instance::get().setCursorMode(m_window, mode);
+}
+
+CursorMode Window::getCursorMode() const {
+	return Instance::get().getCursorMode(m_window);
+}
+
+void Window::setRawMouseMotion(bool ena) {
+	Instance::get().setRawMouseMotion(m_window, ena);
+}
+
+bool Window::getRawMouseMotion() const {
+	return Instance::get().getRawMouseMotion(m_window);
+}
+
 vk::SurfaceKHR Window::createSurface(vk::Instance instance) const {
 	return Instance::get().createSurface(m_window, instance);
 }
 
+WindowState Window::apply(const WindowTransaction& transaction) {
+	return Instance::get().applyTransaction(m_window, transaction, &m_windowedGeometry);
+}
+
 
 
 std::string_view Window::getKeyName(KeyboardKey key, int scancode) {
 	return Instance::get().getKeyName(key, scancode);
 }
+
+bool Window::isRawMouseMotionSupported() {
+	return Instance::get().isRawMouseMotionSupported();
+}
 	
 }
\ No newline at end of file
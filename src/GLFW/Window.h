@@ -85,9 +85,18 @@ public:
 	KeyEvent 						getMouseButtonState(MouseButton but) const;
 	Math::Vec2d 					getMousePosition() const;
 
+	void							setCursorMode(CursorMode mode);
+	CursorMode						getCursorMode() const;
+
+	void							setRawMouseMotion(bool ena);
+	bool							getRawMouseMotion() const;
+
 	vk::SurfaceKHR					createSurface(vk::Instance instance) const;
 
+	WindowState						apply(const WindowTransaction& transaction);
+
 	static std::string_view			getKeyName(KeyboardKey key, int scancode);
+	static bool						isRawMouseMotionSupported();
 
 private:
 	WindowHandle					m_window;
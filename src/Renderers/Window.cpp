@@ -2,7 +2,12 @@
 
 #include "../GLFW/Window.h"
 #include "../GLFWConversions.h"
+#include "../WorkerPool.h"
+#include "../AtomicHistogram.h"
+#include "../AtomicSnapshot.h"
+#include "../RingBuffer.h"
 
+#include <zuazo/LayerBase.h>
 #include <zuazo/Graphics/Vulkan.h>
 #include <zuazo/Graphics/VulkanConversions.h>
 #include <zuazo/Graphics/ColorTransfer.h>
@@ -20,7 +25,10 @@
 #include <set>
 #include <bitset>
 #include <mutex>
+#include <atomic>
 #include <unordered_map>
+#include <unordered_set>
+#include <optional>
 
 namespace Zuazo::Renderers {
 
@@ -29,66 +37,266 @@ namespace Zuazo::Renderers {
  */
 
 struct WindowImpl {
+	static constexpr size_t FRAME_PHASE_COUNT = static_cast<size_t>(Window::FramePhase::present) + 1;
+	using FramePhaseHistograms = std::array<AtomicHistogram, FRAME_PHASE_COUNT>;
+	using LayerSet = std::unordered_set<const LayerBase*>;
+
+	struct WindowState {
+		Math::Vec2i									position;
+		Math::Vec2i									size;
+		Resolution									resolution;
+		Math::Vec2f									scale;
+		Window::InputState							input;
+		bool										focused;
+		bool										iconified;
+		bool										maximized;
+	};
+
+	struct Event {
+		enum class Type : uint8_t {
+			position,
+			size,
+			shouldClose,
+			refresh,
+			focus,
+			iconify,
+			maximize,
+			scale,
+			keyboard,
+			character,
+			mousePosition,
+			mouseEnter,
+			mouseButton,
+			mouseScroll,
+			coalescedMousePosition,
+			coalescedMouseScroll,
+			monitor
+		};
+
+		union Payload {
+			int32_t									integers[3];
+			float									floats[2];
+			double									doubles[2];
+			uint32_t								character;
+			struct {
+				GLFW::MonitorId						id;
+				GLFW::MonitorEvent					event;
+			}										monitor;
+		};
+
+		Type										type;
+		TimePoint									timestamp;
+		Payload										payload;
+
+		static Event integers(Type type, int32_t a = 0, int32_t b = 0, int32_t c = 0) noexcept {
+			Event result;
+			result.type = type;
+			result.payload.integers[0] = a;
+			result.payload.integers[1] = b;
+			result.payload.integers[2] = c;
+			return result;
+		}
+
+		static Event position(int x, int y) noexcept { return integers(Type::position, x, y); }
+		static Event size(int x, int y) noexcept { return integers(Type::size, x, y); }
+		static Event shouldClose() noexcept { return integers(Type::shouldClose); }
+		static Event refresh() noexcept { return integers(Type::refresh); }
+		static Event focus(int focus) noexcept { return integers(Type::focus, focus); }
+		static Event iconify(int iconify) noexcept { return integers(Type::iconify, iconify); }
+		static Event maximize(int maximize) noexcept { return integers(Type::maximize, maximize); }
+		static Event mouseEnter(int entered) noexcept { return integers(Type::mouseEnter, entered); }
+		static Event coalescedMousePosition() noexcept { return integers(Type::coalescedMousePosition); }
+		static Event coalescedMouseScroll() noexcept { return integers(Type::coalescedMouseScroll); }
+
+		static Event keyboard(GLFW::KeyboardKey key, GLFW::KeyEvent event, GLFW::KeyModifiers modifiers) noexcept {
+			return integers(Type::keyboard, static_cast<int32_t>(key), static_cast<int32_t>(event), static_cast<int32_t>(modifiers));
+		}
+
+		static Event mouseButton(GLFW::MouseButton but, GLFW::KeyEvent event, GLFW::KeyModifiers modifiers) noexcept {
+			return integers(Type::mouseButton, static_cast<int32_t>(but), static_cast<int32_t>(event), static_cast<int32_t>(modifiers));
+		}
+
+		static Event scale(float x, float y) noexcept {
+			Event result;
+			result.type = Type::scale;
+			result.payload.floats[0] = x;
+			result.payload.floats[1] = y;
+			return result;
+		}
+
+		static Event character(uint32_t character) noexcept {
+			Event result;
+			result.type = Type::character;
+			result.payload.character = character;
+			return result;
+		}
+
+		static Event doubles(Type type, double x, double y) noexcept {
+			Event result;
+			result.type = type;
+			result.payload.doubles[0] = x;
+			result.payload.doubles[1] = y;
+			return result;
+		}
+
+		static Event mousePosition(double x, double y) noexcept { return doubles(Type::mousePosition, x, y); }
+		static Event mouseScroll(double x, double y) noexcept { return doubles(Type::mouseScroll, x, y); }
+
+		static Event monitor(GLFW::MonitorId id, GLFW::MonitorEvent event) noexcept {
+			Event result;
+			result.type = Type::monitor;
+			result.payload.monitor.id = id;
+			result.payload.monitor.event = event;
+			return result;
+		}
+	};
+
+	using EventRing = RingBuffer<Event, 512>;
+
+	struct LatencyProbe {
+		uint64_t									presentId;
+		TimePoint									inputTime;
+		uint64_t									submission;
+	};
+
 	struct Open {
+		struct SecondaryCommandBuffer {
+			vk::UniqueCommandPool					commandPool;
+			Graphics::CommandBuffer					commandBuffer;
+		};
+
+		struct Frame {
+			Graphics::CommandBuffer					commandBuffer;
+			std::vector<SecondaryCommandBuffer>		secondaryCommandBuffers;
+			vk::UniqueSemaphore 					imageAvailableSemaphore;
+			vk::UniqueSemaphore						renderFinishedSemaphore;
+			vk::UniqueFence							renderFinishedFence;
+			uint64_t								submission;
+		};
+
+		enum Timestamp {
+			TIMESTAMP_BEGIN,
+			TIMESTAMP_LAYERS,
+			TIMESTAMP_FINALIZE,
+			TIMESTAMP_END,
+
+			TIMESTAMP_COUNT
+		};
+
+		struct SurfaceProperties {
+			vk::SurfaceCapabilitiesKHR				capabilities;
+			std::vector<vk::SurfaceFormatKHR>		formats;
+			std::vector<vk::PresentModeKHR>			presentModes;
+		};
+
 		Instance& 									instance;
 		const Graphics::Vulkan&						vulkan;
+		FramePhaseHistograms&						phaseHistograms;
 
 		GLFW::Window								window;
 		vk::UniqueSurfaceKHR						surface;
+		std::optional<SurfaceProperties>			surfaceProperties;
 		vk::UniqueCommandPool						commandPool;
-		Graphics::CommandBuffer						commandBuffer;
+		std::vector<Frame>							frames;
+		size_t										currentFrame;
+		uint64_t									submissionCount;
 		vk::UniqueDescriptorPool					descriptorPool;
 		vk::DescriptorSet							uniformDescriptorSet;
 		vk::PipelineLayout							pipelineLayout;
-		vk::UniqueSemaphore 						imageAvailableSemaphore;
-		vk::UniqueSemaphore							renderFinishedSemaphore;
-		vk::UniqueFence								renderFinishedFence;
 
 		vk::Extent2D								extent;
 		vk::Format									colorFormat;
 		vk::ColorSpaceKHR 							colorSpace;
 		Graphics::ColorTransferWrite				colorTransfer;
 		DepthStencilFormat							depthStencilFormat;
+		vk::PresentModeKHR							presentMode;
+		uint32_t									extraImageCount;
 
+		vk::PresentModeKHR							activePresentMode;
 		vk::UniqueSwapchainKHR						swapchain;
 		std::vector<Graphics::Image>				swapchainImages;
+		std::vector<vk::Fence>						imageFences;
+		bool										swapchainOutdated;
 		Graphics::RenderPass						renderPass;
 		std::vector<vk::UniqueFramebuffer>			framebuffers;
 		Utils::BufferView<const vk::ClearValue>		clearValues;
 		Graphics::UniformBuffer						uniformBuffer;
 
+		bool										parallelRecording;
+		const LayerSet&								parallelLayers;
+
+		bool										framePacing;
+		bool										displayTimingSupported;
+		uint64_t									lastPresentId;
+		Duration									refreshPeriod;
+		std::vector<Window::PresentTiming>			presentTimings;
+		std::vector<VkPastPresentationTimingGOOGLE>	pastPresentationTimings;
+
+		bool										timestampQueries;
+		uint64_t									timestampMask;
+		double										timestampPeriod;
+		vk::UniqueQueryPool							queryPool;
+		std::vector<bool>							pendingQueries;
+		Window::GPUTimings							gpuTimings;
+
 
 		Open(	Instance& instance,
 				Math::Vec2i size,
 				const std::string& title,
 				Window::Monitor monitor,
+				vk::PresentModeKHR presentMode,
+				uint32_t extraImageCount,
+				size_t frameCount,
+				bool parallelRecording,
+				bool framePacing,
+				bool timestampQueries,
 				WindowImpl& impl,
 				const Window::Camera& camera ) 
 			: instance(instance)
 			, vulkan(instance.getVulkan())
+			, phaseHistograms(impl.phaseHistograms)
 			, window(createWindow(size, title, monitor, impl))
 			, surface(createSurface(vulkan, window))
+			, surfaceProperties()
 			, commandPool(createCommandPool(vulkan))
-			, commandBuffer(createCommandBuffer(vulkan, *commandPool))
+			, frames(createFrames(vulkan, *commandPool, frameCount))
+			, currentFrame(0)
+			, submissionCount(0)
 			, descriptorPool(createDescriptorPool(vulkan))
 			, uniformDescriptorSet(createUniformDescriptorSet(vulkan, *descriptorPool))
 			, pipelineLayout(RendererBase::getBasePipelineLayout(vulkan))
-			, imageAvailableSemaphore(vulkan.createSemaphore())
-			, renderFinishedSemaphore(vulkan.createSemaphore())
-			, renderFinishedFence(vulkan.createFence(true))
 
 			, extent(Graphics::toVulkan(window.getResolution()))
 			, colorFormat(vk::Format::eUndefined)
 			, colorSpace(static_cast<vk::ColorSpaceKHR>(-1))
 			, colorTransfer()
 			, depthStencilFormat(DepthStencilFormat::none)
+			, presentMode(presentMode)
+			, extraImageCount(extraImageCount)
 			
+			, activePresentMode(presentMode)
 			, swapchain()
 			, swapchainImages()
+			, imageFences()
+			, swapchainOutdated(false)
 			, renderPass()
 			, framebuffers()
 			, clearValues(Graphics::RenderPass::getClearValues(depthStencilFormat))
 			, uniformBuffer(vulkan, RendererBase::getUniformBufferSizes())
+			, parallelRecording(parallelRecording)
+			, parallelLayers(impl.parallelLayers)
+			, framePacing(framePacing)
+			, displayTimingSupported(hasDisplayTiming(vulkan))
+			, lastPresentId(0)
+			, refreshPeriod(Duration::zero())
+			, presentTimings()
+			, pastPresentationTimings()
+			, timestampQueries(timestampQueries)
+			, timestampMask(getTimestampMask(vulkan))
+			, timestampPeriod(vulkan.getPhysicalDevice().getProperties(vulkan.getDispatcher()).limits.timestampPeriod)
+			, queryPool()
+			, pendingQueries()
+			, gpuTimings{}
 		{
 			uniformBuffer.writeDescirptorSet(vulkan, uniformDescriptorSet);
 			updateProjectionMatrixUniform(camera);
@@ -99,9 +307,10 @@ struct WindowImpl {
 			waitCompletion();
 
 			//Ensure that there are no pending events
-			const auto emitterId = getEmitterId(getUserPointer(window));
+			auto& impl = getUserPointer(window);
 			window = GLFW::Window(); //After this line no more events will be emitted
-			instance.removeEvent(emitterId); //Clean all pending events
+			instance.removeEvent(getEmitterId(impl)); //Clean all pending events
+			impl.discardEvents();
 		}
 
 		void recreate(	vk::Extent2D ext,
@@ -109,6 +318,8 @@ struct WindowImpl {
 						vk::ColorSpaceKHR cs,
 						Graphics::ColorTransferWrite ct,
 						DepthStencilFormat depthStencilFmt,
+						vk::PresentModeKHR presMode,
+						uint32_t extraImages,
 						const Window::Camera& cam ) 
 		{
 			enum {
@@ -162,6 +373,27 @@ struct WindowImpl {
 				modifications.set(RECREATE_CLEAR_VALUES);
 			}
 
+			if(presentMode != presMode) {
+				//Present mode has changed
+				presentMode = presMode;
+
+				modifications.set(RECREATE_SWAPCHAIN);
+			}
+
+			if(extraImageCount != extraImages) {
+				//Image count has changed
+				extraImageCount = extraImages;
+
+				modifications.set(RECREATE_SWAPCHAIN);
+			}
+
+			if(swapchainOutdated) {
+				//Presentation engine has reported that the swapchain no longer matches the surface.
+				//As the extent might not have changed, cached properties can't be trusted
+				invalidateSurfaceProperties();
+				modifications.set(RECREATE_SWAPCHAIN);
+			}
+
 
 
 			//Recreate stuff accordingly
@@ -173,12 +405,22 @@ struct WindowImpl {
 					const auto oldExtent = extent;
 
 					if(extent != vk::Extent2D(0, 0) && colorFormat != vk::Format::eUndefined) {
-						swapchain = createSwapchain(vulkan, *surface, extent, colorFormat, colorSpace, *swapchain);
+						const auto& properties = getSurfaceProperties(extent);
+						swapchain = createSwapchain(vulkan, *surface, properties, extent, colorFormat, colorSpace, presentMode, extraImageCount, *swapchain);
+						activePresentMode = getPresentMode(properties.presentModes, presentMode); //The requested one may be unsupported
 						swapchainImages = createSwapchainImages(vulkan, *swapchain, extent, colorFormat);
 					} else {
 						swapchain.reset();
 						swapchainImages.clear();
 					}
+
+					//Images are not being used by any frame
+					imageFences.assign(swapchainImages.size(), vk::Fence());
+					swapchainOutdated = false;
+					updateQueryPool();
+
+					//Refresh period is queried per swapchain
+					queryRefreshPeriod();
 					
 					modifications.set(RECREATE_FRAMEBUFFERS);
 
@@ -214,117 +456,600 @@ struct WindowImpl {
 				if(modifications.test(UPDATE_PROJECTION_MATRIX)) {
 					updateProjectionMatrixUniform(cam);
 				}
-				
 			}
 		}
 
+		void setSwapchainParameters(vk::PresentModeKHR presMode, 
+									uint32_t extraImages,
+									const Window::Camera& cam ) 
+		{
+			recreate(
+				extent,
+				colorFormat,
+				colorSpace,
+				colorTransfer,
+				depthStencilFormat,
+				presMode,
+				extraImages,
+				cam
+			);
+		}
+
+		void recreateSwapchain(	vk::Extent2D ext,
+								const Window::Camera& cam ) 
+		{
+			swapchainOutdated = true; //Forces the recreation
+			recreate(
+				ext,
+				colorFormat,
+				colorSpace,
+				colorTransfer,
+				depthStencilFormat,
+				presentMode,
+				extraImageCount,
+				cam
+			);
+		}
+
+		bool isSwapchainOutdated() const noexcept {
+			return swapchainOutdated;
+		}
+
+		size_t getImageCount() const noexcept {
+			return swapchainImages.size();
+		}
+
+		vk::PresentModeKHR getActivePresentMode() const noexcept {
+			return activePresentMode;
+		}
+
+		const std::vector<vk::PresentModeKHR>& getPresentModes() {
+			return getSurfaceProperties().presentModes;
+		}
+
+		const std::vector<vk::SurfaceFormatKHR>& getSurfaceFormats() {
+			return getSurfaceProperties().formats;
+		}
+
+		const SurfaceProperties& getSurfaceProperties() {
+			//Querying them is expensive on some drivers, so they are 
+			//only queried again when the surface or the monitor changes
+			if(!surfaceProperties) {
+				const auto& physicalDevice = vulkan.getPhysicalDevice();
+
+				if(!physicalDevice.getSurfaceSupportKHR(0, *surface, vulkan.getDispatcher())){
+					throw Exception("Window surface not suppoted by the physical device");
+				}
+
+				surfaceProperties = SurfaceProperties {
+					physicalDevice.getSurfaceCapabilitiesKHR(*surface, vulkan.getDispatcher()),
+					physicalDevice.getSurfaceFormatsKHR(*surface, vulkan.getDispatcher()),
+					physicalDevice.getSurfacePresentModesKHR(*surface, vulkan.getDispatcher())
+				};
+			}
+
+			assert(surfaceProperties);
+			return *surfaceProperties;
+		}
+
+		const SurfaceProperties& getSurfaceProperties(vk::Extent2D windowExtent) {
+			getSurfaceProperties();
+			assert(surfaceProperties);
+
+			//The current extent follows the size of the window. In that case,
+			//only query the capabilities again when they are outdated
+			auto& capabilities = surfaceProperties->capabilities;
+			if(	capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max() &&
+				capabilities.currentExtent != windowExtent )
+			{
+				capabilities = vulkan.getPhysicalDevice().getSurfaceCapabilitiesKHR(*surface, vulkan.getDispatcher());
+			}
+
+			return *surfaceProperties;
+		}
+
+		void invalidateSurfaceProperties() noexcept {
+			surfaceProperties.reset();
+		}
+
 		void setCamera(const Window::Camera& camera) {
+			//Frames in flight might be reading the uniform buffer
+			waitCompletion();
 			updateProjectionMatrixUniform(camera);
 		}
 
-		void draw(RendererBase& renderer) {
-			//Wait until any previous rendering has finished
-			waitCompletion();
+		void setFrameCount(size_t count) {
+			if(frames.size() != count) {
+				//Command buffers can't be freed while being used
+				waitCompletion();
+
+				frames = createFrames(vulkan, *commandPool, count);
+				currentFrame = 0;
+				std::fill(imageFences.begin(), imageFences.end(), vk::Fence());
+			}
+		}
+
+		void setParallelRecording(bool ena) noexcept {
+			parallelRecording = ena;
+		}
+
+		void setFramePacing(bool ena) noexcept {
+			framePacing = ena;
+		}
+
+		bool hasPresentTiming() const noexcept {
+			return displayTimingSupported;
+		}
+
+		Duration getRefreshPeriod() const noexcept {
+			return refreshPeriod;
+		}
+
+		void resetRefreshPeriod() {
+			//Measure it again, i.e. when moving to another monitor
+			refreshPeriod = Duration::zero();
+			queryRefreshPeriod();
+		}
+
+		void updatePresentTimings() {
+			if(!swapchain) {
+				return;
+			}
+
+			if(displayTimingSupported) {
+				//Query the timings reported by the presentation engine
+				const auto device = static_cast<VkDevice>(vulkan.getDevice());
+				const auto sc = static_cast<VkSwapchainKHR>(*swapchain);
+				uint32_t count = 0;
+
+				vulkan.getDispatcher().vkGetPastPresentationTimingGOOGLE(device, sc, &count, nullptr);
+				pastPresentationTimings.resize(count);
+				if(count > 0) {
+					vulkan.getDispatcher().vkGetPastPresentationTimingGOOGLE(device, sc, &count, pastPresentationTimings.data());
+				}
+
+				for(uint32_t i = 0; i < count; ++i) {
+					const auto& timing = pastPresentationTimings[i];
+
+					//Present times are given in the CLOCK_MONOTONIC domain, as the steady clock
+					presentTimings.push_back(Window::PresentTiming{
+						lastPresentId - static_cast<uint32_t>(static_cast<uint32_t>(lastPresentId) - timing.presentID),
+						TimePoint(std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(timing.actualPresentTime)))
+					});
+				}
+			}
+		}
+
+		void setTimestampQueries(bool ena) {
+			if(timestampQueries != ena) {
+				//Query pool can't be destroyed while being used
+				waitCompletion();
+
+				timestampQueries = ena;
+				updateQueryPool();
+			}
+		}
+
+		const Window::GPUTimings& getGPUTimings() const noexcept {
+			return gpuTimings;
+		}
+
+		void resetGPUTimings() noexcept {
+			gpuTimings = {};
+		}
+
+		enum class DrawResult {
+			presented,
+			timeout,
+			outdated,
+			failed
+		};
+
+		DrawResult draw(RendererBase& renderer, uint64_t acquireTimeout) {
+			auto& frame = frames[currentFrame];
+
+			if(framebuffers.empty()) {
+				return DrawResult::failed;
+			}
+
+			//Wait until the previous rendering on this frame has finished
+			auto timestamp = Clock::now();
+			vulkan.waitForFences(*frame.renderFinishedFence);
+			const auto fenceWaitEnd = Clock::now();
+			auto fenceWait = fenceWaitEnd - timestamp;
+			timestamp = fenceWaitEnd;
 
 			//Acquire an image from the swapchain
-			size_t index = acquireImage();
+			uint32_t index;
+			const auto acquireResult = acquireImage(*frame.imageAvailableSemaphore, acquireTimeout, index);
+			timestamp = recordPhase(Window::FramePhase::acquire, timestamp);
+
+			if(acquireResult == vk::Result::eTimeout || acquireResult == vk::Result::eNotReady) {
+				//The presentation engine did not release any image on time
+				return DrawResult::timeout;
+			} else if(acquireResult == vk::Result::eErrorOutOfDateKHR) {
+				//Swapchain can't be used anymore
+				swapchainOutdated = true;
+				return DrawResult::outdated;
+			} else if(acquireResult == vk::Result::eSuboptimalKHR) {
+				//Image can still be presented, but the swapchain should be recreated afterwards
+				swapchainOutdated = true;
+			} else if(acquireResult != vk::Result::eSuccess) {
+				return DrawResult::failed;
+			}
+			assert(index < framebuffers.size());
+
+			//Ensure that no other frame is rendering to this image
+			if(imageFences[index] && imageFences[index] != *frame.renderFinishedFence) {
+				vulkan.waitForFences(imageFences[index]);
+
+				const auto imageWaitEnd = Clock::now();
+				fenceWait += imageWaitEnd - timestamp;
+				timestamp = imageWaitEnd;
+			}
+			imageFences[index] = *frame.renderFinishedFence;
+			phaseHistograms[static_cast<size_t>(Window::FramePhase::fenceWait)].record(fenceWait);
+
+			//Previous rendering on this image has finished, so its timestamps are available
+			if(queryPool && pendingQueries[index]) {
+				resolveTimestamps(index);
+			}
+
+			//Flush the unform buffer if it is going to be used
+			if(!renderer.getLayers().empty()) {
+				uniformBuffer.flush(vulkan);
+			}
+			timestamp = recordPhase(Window::FramePhase::uniformFlush, timestamp);
+
+			//Record the commands to be executed
+			recordCommandBuffer(
+				frame.commandBuffer, 
+				frame.secondaryCommandBuffers, 
+				framebuffers[index].get(), 
+				index,
+				renderer, 
+				vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+			);
+			const auto& commandBuffer = frame.commandBuffer;
+			timestamp = recordPhase(Window::FramePhase::recording, timestamp);
 
-			if(index < framebuffers.size()) {
-				const auto frameBuffer = framebuffers[index].get();
+			//Send it to the queue
+			const std::array imageAvailableSemaphores = {
+				*frame.imageAvailableSemaphore
+			};
+			const std::array renderFinishedSemaphores = {
+				*frame.renderFinishedSemaphore
+			};
+			const std::array commandBuffers = {
+				commandBuffer.get()
+			};
+			const std::array pipelineStages = {
+				vk::PipelineStageFlags(vk::PipelineStageFlagBits::eColorAttachmentOutput)
+			};
+			const vk::SubmitInfo subInfo(
+				imageAvailableSemaphores.size(), imageAvailableSemaphores.data(),	//Wait semaphores
+				pipelineStages.data(),												//Pipeline stages
+				commandBuffers.size(), commandBuffers.data(),						//Command buffers
+				renderFinishedSemaphores.size(), renderFinishedSemaphores.data()	//Signal semaphores
+			);
+			vulkan.resetFences(*frame.renderFinishedFence);
+			vulkan.submit(vulkan.getGraphicsQueue(), subInfo, *frame.renderFinishedFence);
+			frame.submission = ++submissionCount;
+			if(queryPool) {
+				pendingQueries[index] = true;
+			}
+			timestamp = recordPhase(Window::FramePhase::submit, timestamp);
+
+			//Present it
+			const auto presentResult = presentImage(renderFinishedSemaphores.front(), index);
+			recordPhase(Window::FramePhase::present, timestamp);
+			if(	presentResult == vk::Result::eErrorOutOfDateKHR || 
+				presentResult == vk::Result::eSuboptimalKHR ) 
+			{
+				//Recreate the swapchain before drawing the next frame
+				swapchainOutdated = true;
+			}
+
+			//Advance to the next frame
+			currentFrame = (currentFrame + 1) % frames.size();
+
+			return DrawResult::presented;
+		}
+
+		uint64_t getLastSubmission() const noexcept {
+			return submissionCount;
+		}
+
+		bool isSubmissionCompleted(uint64_t submission) const {
+			//Fences are reused, so look for the frame which still holds this submission.
+			//Frames are only reused or destroyed after waiting for their submission
+			for(const auto& frame : frames) {
+				if(frame.submission == submission) {
+					return vulkan.getDevice().getFenceStatus(*frame.renderFinishedFence, vulkan.getDispatcher()) == vk::Result::eSuccess;
+				}
+			}
+
+			return true;
+		}
+
+		void waitCompletion() {
+			const auto timestamp = Clock::now();
+
+			for(const auto& frame : frames) {
+				vulkan.waitForFences(*frame.renderFinishedFence);
+			}
+
+			recordPhase(Window::FramePhase::fenceWait, timestamp);
+		}
+
+	private:
+		TimePoint recordPhase(Window::FramePhase phase, TimePoint begin) noexcept {
+			const auto end = Clock::now();
+			phaseHistograms[static_cast<size_t>(phase)].record(end - begin);
+			return end;
+		}
 
-				//Begin writing to the command buffer. //TODO maybe reset pool?
-				constexpr vk::CommandBufferBeginInfo cmdBegin(
-					vk::CommandBufferUsageFlagBits::eOneTimeSubmit, 
-					nullptr
+		void recordCommandBuffer(	Graphics::CommandBuffer& commandBuffer,
+									std::vector<SecondaryCommandBuffer>& secondaryCommandBuffers,
+									vk::Framebuffer frameBuffer,
+									uint32_t index,
+									RendererBase& renderer,
+									vk::CommandBufferUsageFlags usage )
+		{
+			//Decide how many groups of layers are going to be recorded in parallel.
+			//Otherwise, layers are drawn by the renderer from this thread
+			const auto& layers = renderer.getLayers();
+			const size_t groupCount = (parallelRecording && isParallelRecordable(layers))
+				? std::min(layers.size(), getWorkerPool().getConcurrency()) 
+				: 0;
+			const bool useSecondaryCommandBuffers = groupCount > 1;
+
+			//Begin writing to the command buffer. //TODO maybe reset pool?
+			const vk::CommandBufferBeginInfo cmdBegin(
+				usage, 
+				nullptr
+			);
+			commandBuffer.begin(cmdBegin);
+
+			//Queries need to be reset outside the renderpass
+			if(queryPool) {
+				commandBuffer.get().resetQueryPool(
+					*queryPool, 
+					index * TIMESTAMP_COUNT, TIMESTAMP_COUNT, 
+					vulkan.getDispatcher()
 				);
-				commandBuffer.begin(cmdBegin);
-
-				//Begin a render pass
-				const vk::RenderPassBeginInfo rendBegin(
-					renderPass.get(),													//Renderpass
-					frameBuffer,														//Target framebuffer
-					vk::Rect2D({0, 0}, extent),											//Extent
-					clearValues.size(), clearValues.data()								//Attachment clear values
+				writeTimestamp(commandBuffer, vk::PipelineStageFlagBits::eTopOfPipe, index, TIMESTAMP_BEGIN);
+			}
+
+			//Begin a render pass
+			const vk::RenderPassBeginInfo rendBegin(
+				renderPass.get(),													//Renderpass
+				frameBuffer,														//Target framebuffer
+				vk::Rect2D({0, 0}, extent),											//Extent
+				clearValues.size(), clearValues.data()								//Attachment clear values
+			);
+			commandBuffer.beginRenderPass(
+				rendBegin, 
+				useSecondaryCommandBuffers ? vk::SubpassContents::eSecondaryCommandBuffers : vk::SubpassContents::eInline
+			);
+
+			//Set the dynamic state
+			setDynamicState(commandBuffer);
+
+			//Evaluate if there are any layers and if so, draw them
+			if(useSecondaryCommandBuffers) {
+				//Record the layers in parallel and execute them
+				recordSecondaryCommandBuffers(secondaryCommandBuffers, groupCount, frameBuffer, index, renderer, usage);
+
+				std::vector<vk::CommandBuffer> handles;
+				handles.reserve(groupCount);
+				for(size_t i = 0; i < groupCount; ++i) {
+					handles.push_back(secondaryCommandBuffers[i].commandBuffer.get());
+				}
+
+				commandBuffer.get().executeCommands(handles, vulkan.getDispatcher());
+			} else if(!layers.empty()) {
+				//Bind the descriptor set
+				bindUniformDescriptorSet(commandBuffer);
+
+				//Draw all the layers
+				renderer.draw(commandBuffer);
+
+				if(queryPool) {
+					writeTimestamp(commandBuffer, vk::PipelineStageFlagBits::eBottomOfPipe, index, TIMESTAMP_LAYERS);
+				}
+			} else if(queryPool) {
+				//Nothing to draw
+				writeTimestamp(commandBuffer, vk::PipelineStageFlagBits::eBottomOfPipe, index, TIMESTAMP_LAYERS);
+			}
+
+			//Finalize the renderpass if needed
+			renderPass.finalize(vulkan, commandBuffer.get());
+
+			//Only execute commands may be recorded in subpasses with secondary contents,
+			//so in that case the timestamp is written after the renderpass
+			if(queryPool && !useSecondaryCommandBuffers) {
+				writeTimestamp(commandBuffer, vk::PipelineStageFlagBits::eBottomOfPipe, index, TIMESTAMP_FINALIZE);
+			}
+
+			//End everything
+			commandBuffer.endRenderPass();
+
+			if(queryPool) {
+				if(useSecondaryCommandBuffers) {
+					writeTimestamp(commandBuffer, vk::PipelineStageFlagBits::eBottomOfPipe, index, TIMESTAMP_FINALIZE);
+				}
+				writeTimestamp(commandBuffer, vk::PipelineStageFlagBits::eBottomOfPipe, index, TIMESTAMP_END);
+			}
+
+			commandBuffer.end();
+		}
+
+		template<typename Layers>
+		bool isParallelRecordable(const Layers& layers) const {
+			//Layers are drawn directly from the worker threads, bypassing the
+			//renderer. Only do it when all of them have declared it to be safe
+			return std::all_of(
+				layers.cbegin(), layers.cend(),
+				[this] (const auto& layer) -> bool {
+					return parallelLayers.count(&static_cast<const LayerBase&>(layer)) > 0;
+				}
+			);
+		}
+
+		void recordSecondaryCommandBuffers(	std::vector<SecondaryCommandBuffer>& secondaryCommandBuffers,
+											size_t groupCount,
+											vk::Framebuffer frameBuffer,
+											uint32_t index,
+											RendererBase& renderer,
+											vk::CommandBufferUsageFlags usage )
+		{
+			//Each group needs its own pool, as pools can't be used concurrently
+			while(secondaryCommandBuffers.size() < groupCount) {
+				auto pool = createCommandPool(vulkan);
+				auto cmd = Graphics::CommandBuffer(
+					vulkan,
+					vulkan.allocateCommnadBuffer(*pool, vk::CommandBufferLevel::eSecondary)
 				);
-				commandBuffer.beginRenderPass(rendBegin, vk::SubpassContents::eInline);
-
-				//Set the dynamic viewport
-				const std::array viewports = {
-					vk::Viewport(
-						0.0f, 0.0f,										//Origin
-						static_cast<float>(extent.width), 				//Width
-						static_cast<float>(extent.height),				//Height
-						0.0f, 1.0f										//min, max depth
-					),
-				};
-				commandBuffer.setViewport(0, viewports);
-
-				//Set the dynamic scissor
-				const std::array scissors = {
-					vk::Rect2D(
-						{ 0, 0 },										//Origin
-						extent											//Size
-					),
-				};
-				commandBuffer.setScissor(0, scissors);
-
-				//Evaluate if there are any layers and if so, draw them
-				if(!renderer.getLayers().empty()) {
-					//Flush the unform buffer
-					uniformBuffer.flush(vulkan);
-
-					//Bind the descriptor set
-					commandBuffer.bindDescriptorSets(
-						vk::PipelineBindPoint::eGraphics,					//Pipeline bind point
-						pipelineLayout,										//Pipeline layout
-						RendererBase::DESCRIPTOR_SET,						//First index
-						uniformDescriptorSet,								//Descriptor sets
-						{}													//Dynamic offsets
-					);
 
-					//Draw all the layers
-					renderer.draw(commandBuffer);
+				secondaryCommandBuffers.push_back(SecondaryCommandBuffer{
+					std::move(pool),
+					std::move(cmd)
+				});
+			}
+
+			const vk::CommandBufferInheritanceInfo inheritance(
+				renderPass.get(),													//Renderpass
+				0,																	//Subpass
+				frameBuffer															//Target framebuffer
+			);
+			const vk::CommandBufferBeginInfo cmdBegin(
+				usage | vk::CommandBufferUsageFlagBits::eRenderPassContinue, 
+				&inheritance
+			);
+
+			//Split the layers into contiguous groups, so that order is preserved
+			const auto& layers = renderer.getLayers();
+			const size_t layerCount = layers.size();
+
+			getWorkerPool().parallelFor(
+				groupCount,
+				[&] (size_t group) {
+					auto& commandBuffer = secondaryCommandBuffers[group].commandBuffer;
+					const size_t begin = group * layerCount / groupCount;
+					const size_t end = (group + 1) * layerCount / groupCount;
+
+					commandBuffer.begin(cmdBegin);
+
+					//State is not inherited from the primary command buffer
+					setDynamicState(commandBuffer);
+					bindUniformDescriptorSet(commandBuffer);
+
+					for(size_t i = begin; i < end; ++i) {
+						static_cast<LayerBase&>(layers[i]).draw(renderer, commandBuffer);
+					}
+
+					//Groups are executed in order, so the last one marks the end of the layers
+					if(queryPool && group == groupCount - 1) {
+						writeTimestamp(commandBuffer, vk::PipelineStageFlagBits::eBottomOfPipe, index, TIMESTAMP_LAYERS);
+					}
+
+					commandBuffer.end();
 				}
+			);
+		}
 
-				//Finalize the renderpass if needed
-				renderPass.finalize(vulkan, commandBuffer.get());
+		void setDynamicState(Graphics::CommandBuffer& commandBuffer) const {
+			//Set the dynamic viewport
+			const std::array viewports = {
+				vk::Viewport(
+					0.0f, 0.0f,										//Origin
+					static_cast<float>(extent.width), 				//Width
+					static_cast<float>(extent.height),				//Height
+					0.0f, 1.0f										//min, max depth
+				),
+			};
+			commandBuffer.setViewport(0, viewports);
+
+			//Set the dynamic scissor
+			const std::array scissors = {
+				vk::Rect2D(
+					{ 0, 0 },										//Origin
+					extent											//Size
+				),
+			};
+			commandBuffer.setScissor(0, scissors);
+		}
 
-				//End everything
-				commandBuffer.endRenderPass();
-				commandBuffer.end();
+		void writeTimestamp(Graphics::CommandBuffer& commandBuffer,
+							vk::PipelineStageFlagBits stage,
+							uint32_t index,
+							Timestamp timestamp ) const
+		{
+			assert(queryPool);
+			commandBuffer.get().writeTimestamp(
+				stage,
+				*queryPool,
+				index * TIMESTAMP_COUNT + timestamp,
+				vulkan.getDispatcher()
+			);
+		}
 
-				//Send it to the queue
-				const std::array imageAvailableSemaphores = {
-					*imageAvailableSemaphore
-				};
-				const std::array renderFinishedSemaphores = {
-					*renderFinishedSemaphore
-				};
-				const std::array commandBuffers = {
-					commandBuffer.get()
-				};
-				const std::array pipelineStages = {
-					vk::PipelineStageFlags(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-				};
-				const vk::SubmitInfo subInfo(
-					imageAvailableSemaphores.size(), imageAvailableSemaphores.data(),	//Wait semaphores
-					pipelineStages.data(),												//Pipeline stages
-					commandBuffers.size(), commandBuffers.data(),						//Command buffers
-					renderFinishedSemaphores.size(), renderFinishedSemaphores.data()	//Signal semaphores
+		void updateQueryPool() {
+			if(timestampQueries && timestampMask && !swapchainImages.empty()) {
+				//Each image has its own set of timestamps, as only one frame can render to it at a time
+				const vk::QueryPoolCreateInfo createInfo(
+					{},																//Flags
+					vk::QueryType::eTimestamp,										//Query type
+					swapchainImages.size() * TIMESTAMP_COUNT						//Query count
 				);
-				vulkan.resetFences(*renderFinishedFence);
-				vulkan.submit(vulkan.getGraphicsQueue(), subInfo, *renderFinishedFence);
 
-				//Present it
-				vulkan.present(*swapchain, index, renderFinishedSemaphores.front());
+				queryPool = vulkan.getDevice().createQueryPoolUnique(createInfo, nullptr, vulkan.getDispatcher());
+				pendingQueries.assign(swapchainImages.size(), false);
+			} else {
+				queryPool.reset();
+				pendingQueries.clear();
 			}
 		}
 
-		void waitCompletion() {
-			vulkan.waitForFences(*renderFinishedFence);
+		void resolveTimestamps(uint32_t index) {
+			assert(queryPool);
+			assert(index < pendingQueries.size());
+
+			std::array<uint64_t, TIMESTAMP_COUNT> timestamps;
+			const auto result = vulkan.getDevice().getQueryPoolResults(
+				*queryPool,
+				index * TIMESTAMP_COUNT, TIMESTAMP_COUNT,
+				sizeof(timestamps), timestamps.data(), sizeof(uint64_t),
+				vk::QueryResultFlagBits::e64,
+				vulkan.getDispatcher()
+			);
+			pendingQueries[index] = false;
+
+			if(result == vk::Result::eSuccess) {
+				const auto toDuration = [this, &timestamps] (Timestamp begin, Timestamp end) -> Duration {
+					const auto ticks = (timestamps[end] - timestamps[begin]) & timestampMask;
+					return std::chrono::duration_cast<Duration>(
+						std::chrono::duration<double, std::nano>(ticks * timestampPeriod)
+					);
+				};
+
+				updateStatistics(gpuTimings.renderPass, toDuration(TIMESTAMP_BEGIN, TIMESTAMP_END));
+				updateStatistics(gpuTimings.layers, toDuration(TIMESTAMP_BEGIN, TIMESTAMP_LAYERS));
+				updateStatistics(gpuTimings.finalize, toDuration(TIMESTAMP_LAYERS, TIMESTAMP_FINALIZE));
+			}
+		}
+
+		void bindUniformDescriptorSet(Graphics::CommandBuffer& commandBuffer) const {
+			commandBuffer.bindDescriptorSets(
+				vk::PipelineBindPoint::eGraphics,					//Pipeline bind point
+				pipelineLayout,										//Pipeline layout
+				RendererBase::DESCRIPTOR_SET,						//First index
+				uniformDescriptorSet,								//Descriptor sets
+				{}													//Dynamic offsets
+			);
 		}
 
-	private:
 		void updateProjectionMatrixUniform(const Window::Camera& cam) {
 			uniformBuffer.waitCompletion(vulkan);
 
@@ -338,18 +1063,71 @@ struct WindowImpl {
 			);
 		}
 
-		size_t acquireImage() {
-			uint32_t index;
-			const vk::Result result = vulkan.getDevice().acquireNextImageKHR(
+		vk::Result acquireImage(vk::Semaphore imageAvailableSemaphore, 
+								uint64_t timeout,
+								uint32_t& index )
+		{
+			if(!swapchain) {
+				return vk::Result::eErrorOutOfDateKHR;
+			}
+
+			return vulkan.getDevice().acquireNextImageKHR(
 				*swapchain, 						
-				Graphics::Vulkan::NO_TIMEOUT,
-				*imageAvailableSemaphore,
+				timeout,
+				imageAvailableSemaphore,
 				nullptr,
 				&index,
 				vulkan.getDispatcher()
 			);
+		}
+
+		vk::Result presentImage(vk::Semaphore renderFinishedSemaphore,
+								uint32_t index )
+		{
+			assert(swapchain);
+
+			const std::array swapchains = {
+				*swapchain
+			};
+			const std::array indices = {
+				index
+			};
+			vk::PresentInfoKHR presentInfo(
+				1, &renderFinishedSemaphore,										//Wait semaphores
+				swapchains.size(), swapchains.data(), indices.data(),				//Swapchains and image indices
+				nullptr																//Results
+			);
+
+			//Identify the present, so that its timing can be queried afterwards
+			const uint64_t presentId = ++lastPresentId;
+
+			const vk::PresentTimeGOOGLE presentTime(
+				static_cast<uint32_t>(presentId),									//Present id
+				0																	//Desired present time (ASAP)
+			);
+			vk::PresentTimesInfoGOOGLE presentTimesInfo(1, &presentTime);
+			if(displayTimingSupported) {
+				presentTimesInfo.pNext = presentInfo.pNext;
+				presentInfo.pNext = &presentTimesInfo;
+			}
+
+			//Use the C-style overload, as it reports out of date swapchains without throwing
+			return vulkan.getPresentationQueue().presentKHR(&presentInfo, vulkan.getDispatcher());
+		}
 
-			return (result == vk::Result::eSuccess) || (result == vk::Result::eSuboptimalKHR) ? index : framebuffers.size();
+		void queryRefreshPeriod() {
+			if(displayTimingSupported && swapchain) {
+				VkRefreshCycleDurationGOOGLE duration;
+				const auto result = vulkan.getDispatcher().vkGetRefreshCycleDurationGOOGLE(
+					static_cast<VkDevice>(vulkan.getDevice()),
+					static_cast<VkSwapchainKHR>(*swapchain),
+					&duration
+				);
+
+				if(result == VK_SUCCESS) {
+					refreshPeriod = std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(duration.refreshDuration));
+				}
+			}
 		}
 
 
@@ -367,7 +1145,7 @@ struct WindowImpl {
 				windowFocusCallback,
 				windowIconifyCallback,
 				windowMaximizeCallback,
-				nullptr,
+				windowResolutionCallback,
 				windowScaleCallback,
 				windowKeyCallback,
 				windowCharCallback,
@@ -380,7 +1158,7 @@ struct WindowImpl {
 			return GLFW::Window(
 				size, 
 				title.c_str(), 
-				reinterpret_cast<const GLFW::Monitor&>(monitor), 
+				getMonitorHandle(monitor), 
 				callbacks, 
 				&impl
 			);
@@ -424,6 +1202,29 @@ struct WindowImpl {
 			);
 		}
 
+		static std::vector<Frame> createFrames(	const Graphics::Vulkan& vulkan,
+												vk::CommandPool pool,
+												size_t count )
+		{
+			assert(count > 0);
+			std::vector<Frame> result;
+			result.reserve(count);
+
+			for(size_t i = 0; i < count; ++i) {
+				result.push_back(Frame{
+					createCommandBuffer(vulkan, pool),
+					{},
+					vulkan.createSemaphore(),
+					vulkan.createSemaphore(),
+					vulkan.createFence(true),
+					0
+				});
+			}
+
+			assert(result.size() == count);
+			return result;
+		}
+
 		static vk::UniqueDescriptorPool createDescriptorPool(const Graphics::Vulkan& vulkan){
 			std::vector<vk::DescriptorPoolSize> poolSizes;
 			poolSizes.insert(
@@ -450,29 +1251,24 @@ struct WindowImpl {
 
 		static vk::UniqueSwapchainKHR createSwapchain(	const Graphics::Vulkan& vulkan, 
 														vk::SurfaceKHR surface, 
+														const SurfaceProperties& properties,
 														vk::Extent2D& extent, 
 														vk::Format format,
 														vk::ColorSpaceKHR colorSpace,
+														vk::PresentModeKHR desiredPresentMode,
+														uint32_t extraImageCount,
 														vk::SwapchainKHR old )
 		{
-			const auto& physicalDevice = vulkan.getPhysicalDevice();
+			const auto& capabilities = properties.capabilities;
+			const auto imageCount = getImageCount(capabilities, extraImageCount);
+			extent = getExtent(capabilities, extent);
 
-			if(!physicalDevice.getSurfaceSupportKHR(0, surface, vulkan.getDispatcher())){
-				throw Exception("Window surface not suppoted by the physical device");
-			}
-
-			const auto capabilities = physicalDevice.getSurfaceCapabilitiesKHR(surface, vulkan.getDispatcher());
-			const auto imageCount = getImageCount(capabilities);
-			extent = getExtent(capabilities, extent);
-
-			const auto surfaceFormats = physicalDevice.getSurfaceFormatsKHR(surface, vulkan.getDispatcher());
-			const auto surfaceFormat = getSurfaceFormat(surfaceFormats, vk::SurfaceFormatKHR(format, colorSpace));
+			const auto surfaceFormat = getSurfaceFormat(properties.formats, vk::SurfaceFormatKHR(format, colorSpace));
 
 			const auto queueFamilies = getQueueFamilies(vulkan);
 			const auto sharingMode = (queueFamilies.size() > 1) ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive;
 			
-			const auto presentModes = physicalDevice.getSurfacePresentModesKHR(surface, vulkan.getDispatcher());
-			const auto presentMode = getPresentMode(presentModes);
+			const auto presentMode = getPresentMode(properties.presentModes, desiredPresentMode);
 
 			const vk::SwapchainCreateInfoKHR createInfo(
 				{},													//Flags
@@ -601,8 +1397,10 @@ struct WindowImpl {
 			throw Exception("Unsupported format!");
 		}
 
-		static uint32_t getImageCount(const vk::SurfaceCapabilitiesKHR& cap){
-			const uint32_t desired = cap.minImageCount + 1;
+		static uint32_t getImageCount(	const vk::SurfaceCapabilitiesKHR& cap,
+										uint32_t extra )
+		{
+			const uint32_t desired = cap.minImageCount + extra;
 
 			if(cap.maxImageCount){
 				return std::min(desired, cap.maxImageCount);
@@ -611,9 +1409,12 @@ struct WindowImpl {
 			}
 		}
 
-		static vk::PresentModeKHR getPresentMode(const std::vector<vk::PresentModeKHR>& presentModes){
+		static vk::PresentModeKHR getPresentMode(	const std::vector<vk::PresentModeKHR>& presentModes,
+													vk::PresentModeKHR desired )
+		{
 			const std::array preferred = {
-				vk::PresentModeKHR::eMailbox,
+				desired,
+				(desired == vk::PresentModeKHR::eImmediate) ? vk::PresentModeKHR::eMailbox : desired, //Next lowest latency
 				vk::PresentModeKHR::eFifo //Required to be supported.
 			};
 
@@ -626,6 +1427,36 @@ struct WindowImpl {
 			throw Exception("No compatible presentation mode was found");
 		}
 
+		static uint64_t getTimestampMask(const Graphics::Vulkan& vulkan) {
+			const auto queueFamilies = vulkan.getPhysicalDevice().getQueueFamilyProperties(vulkan.getDispatcher());
+			assert(vulkan.getGraphicsQueueIndex() < queueFamilies.size());
+			const auto validBits = queueFamilies[vulkan.getGraphicsQueueIndex()].timestampValidBits;
+
+			//Zero if timestamps are not supported
+			return (validBits < 64) ? ((uint64_t(1) << validBits) - 1) : ~uint64_t(0);
+		}
+
+		static void updateStatistics(Window::DurationStatistics& stats, Duration value) noexcept {
+			constexpr int AVERAGE_WEIGHT = 16;
+
+			stats.last = value;
+			stats.average = (stats.average == Duration::zero()) 
+				? value 
+				: stats.average + (value - stats.average) / AVERAGE_WEIGHT;
+			stats.max = std::max(stats.max, value);
+		}
+
+		static bool hasDisplayTiming(const Graphics::Vulkan& vulkan) noexcept {
+			//Entry points are only loaded when the extension is enabled in the device
+			return	vulkan.getDispatcher().vkGetPastPresentationTimingGOOGLE != nullptr &&
+					vulkan.getDispatcher().vkGetRefreshCycleDurationGOOGLE != nullptr ;
+		}
+
+		static WorkerPool& getWorkerPool() {
+			static WorkerPool pool;
+			return pool;
+		}
+
 		static std::vector<uint32_t> getQueueFamilies(const Graphics::Vulkan& vulkan){
 			const std::set<uint32_t> families = {
 				vulkan.getGraphicsQueueIndex(),
@@ -646,6 +1477,48 @@ struct WindowImpl {
 	bool										decorated;
 	bool										visible;
 	Window::Monitor								monitor;
+	bool										borderless;
+	GLFW::MonitorId								occupiedMonitor;
+	Duration									refreshPeriod;
+	Rate										refreshRate;
+	Rate										refreshRateCandidate;
+	size_t										refreshRateCandidateCount;
+	Window::LatencyProfile						latencyProfile;
+	Window::PresentMode							presentMode;
+	uint32_t									extraImageCount;
+	size_t										framesInFlight;
+	bool										parallelRecording;
+	LayerSet									parallelLayers;
+	Duration									acquireTimeout;
+	Window::AcquirePolicy						acquirePolicy;
+	size_t										skippedFrameCount;
+	size_t										lateFrameCount;
+	bool										framePacing;
+	Duration									scheduledPeriod;
+	bool										timestampQueries;
+	FramePhaseHistograms						phaseHistograms;
+	std::atomic<bool>							inputLatencyMeasurement;
+	std::atomic<TimePoint>						pendingInputTime;
+	std::vector<LatencyProbe>					latencyProbes;
+	AtomicHistogram								inputLatencyHistogram;
+	AtomicSnapshot<WindowState>					windowState;
+	std::atomic<bool>							inputCoalescing;
+	std::atomic<bool>							mousePositionPending;
+	std::atomic<bool>							mouseScrollPending;
+	AtomicSnapshot<Math::Vec2d>					pendingMouseScroll;
+	std::atomic<uint64_t>						coalescedEventCount;
+	EventRing									events;
+	std::atomic<bool>							eventsPending;
+	std::mutex									eventOverflowMutex;
+	std::vector<Event>							eventOverflow;
+	std::atomic<bool>							eventOverflowed;
+	std::atomic<uint64_t>						eventOverflowCount;
+	TimePoint									eventTimestamp;
+	std::atomic<TimePoint>						mousePositionTimestamp;
+	std::atomic<TimePoint>						mouseScrollTimestamp;
+	std::atomic<bool>							rawMouseMotion;
+	std::atomic<uint64_t>						mouseMotion;
+	Math::Vec2d									mouseMotionResidual;
 
 	Window::Callbacks							callbacks;
 	
@@ -655,6 +1528,12 @@ struct WindowImpl {
 
 	static constexpr auto PRIORITY = Instance::consumerPriority;
 	static constexpr auto NO_POSTION = Math::Vec2i(std::numeric_limits<int32_t>::min());
+	static constexpr double MOUSE_MOTION_SCALE = 256.0; //Fixed point with 8 fractional bits
+	static constexpr size_t REFRESH_RATE_HYSTERESIS = 60; //Updates with present timing
+
+	//Opened windows, which need to be notified about monitor hotplugs
+	static inline std::mutex					s_monitorListenersMutex;
+	static inline std::vector<WindowImpl*>		s_monitorListeners;
 
 	WindowImpl(	Window& owner,
 				Instance& instance,
@@ -669,6 +1548,48 @@ struct WindowImpl {
 		, decorated(true)
 		, visible(true)
 		, monitor(mon)
+		, borderless(false)
+		, occupiedMonitor(GLFW::NO_MONITOR_ID)
+		, refreshPeriod(Duration::zero())
+		, refreshRate(0, 1)
+		, refreshRateCandidate(0, 1)
+		, refreshRateCandidateCount(0)
+		, latencyProfile(Window::LatencyProfile::balanced)
+		, presentMode(getProfilePresentMode(latencyProfile))
+		, extraImageCount(getProfileExtraImageCount(latencyProfile))
+		, framesInFlight(1)
+		, parallelRecording(false)
+		, parallelLayers()
+		, acquireTimeout(Duration::max())
+		, acquirePolicy(Window::AcquirePolicy::retry)
+		, skippedFrameCount(0)
+		, lateFrameCount(0)
+		, framePacing(false)
+		, scheduledPeriod(Duration::zero())
+		, timestampQueries(false)
+		, phaseHistograms()
+		, inputLatencyMeasurement(false)
+		, pendingInputTime(TimePoint())
+		, latencyProbes()
+		, inputLatencyHistogram()
+		, windowState()
+		, inputCoalescing(false)
+		, mousePositionPending(false)
+		, mouseScrollPending(false)
+		, pendingMouseScroll()
+		, coalescedEventCount(0)
+		, events()
+		, eventsPending(false)
+		, eventOverflowMutex()
+		, eventOverflow()
+		, eventOverflowed(false)
+		, eventOverflowCount(0)
+		, eventTimestamp()
+		, mousePositionTimestamp(TimePoint())
+		, mouseScrollTimestamp(TimePoint())
+		, rawMouseMotion(false)
+		, mouseMotion(0)
+		, mouseMotionResidual()
 		, callbacks()
 	{
 	}
@@ -691,23 +1612,46 @@ struct WindowImpl {
 			window.getInstance(),
 			size,
 			title,
-			monitor,
+			isBorderless() ? Window::NO_MONITOR : monitor,
+			toVulkan(presentMode),
+			extraImageCount,
+			framesInFlight,
+			parallelRecording,
+			framePacing,
+			timestampQueries,
 			*this,
 			window.getCamera()
 		);
 		
-		//Set everything as desired
-		//newOpened->window.setName(windowName); //Already set when constructing
-		//newOpened->window.setSize(size); //Already set when constructing
-		if(position != NO_POSTION) newOpened->window.setPosition(position);
-		newOpened->window.setOpacity(opacity);
-		newOpened->window.setResizeable(resizeable);
-		newOpened->window.setDecorated(decorated);
-		newOpened->window.setVisibility(visible);
+		//Set everything as desired in a single round-trip. 
+		//Name and size are already set when constructing
+		GLFW::WindowTransaction transaction;
+		if(position != NO_POSTION) transaction.position = position;
+		transaction.opacity = opacity;
+		transaction.resizeable = resizeable;
+		transaction.decorated = decorated;
+		transaction.visibility = visible;
+		if(rawMouseMotion) {
+			transaction.cursorMode = GLFW::CursorMode::disabled;
+			transaction.rawMouseMotion = true;
+		}
+		applyTransaction(newOpened->window, transaction);
+
+		//Borderless windows are created windowed, so that the
+		//geometry above is restored when leaving it
+		if(isBorderless()) {
+			GLFW::WindowTransaction borderlessTransaction;
+			borderlessTransaction.monitor = GLFW::WindowMonitorChange{ getMonitorHandle(monitor), nullptr };
+			applyTransaction(newOpened->window, borderlessTransaction);
+		}
 		if(lock) lock->lock();
 
 		//Write changes after locking back
 		opened = std::move(newOpened);
+		addMonitorListener(*this);
+		occupiedMonitor = findOccupiedMonitor();
+		refreshPeriod = opened->getRefreshPeriod();
+		refreshRate = getRefreshRate();
 		window.setVideoModeCompatibility(getVideoModeCompatibility());
 
 		hasChanged = true;
@@ -729,12 +1673,18 @@ struct WindowImpl {
 		window.disablePeriodicUpdate();
 		window.setViewportSize(Math::Vec2f());
 		window.setRenderPass(vk::RenderPass());
+		latencyProbes.clear();
+		removeMonitorListener(*this);
 		auto oldOpened = std::move(opened);
 
 		if(lock) lock->unlock();
 		oldOpened.reset();
 		if(lock) lock->lock();
 
+		//Callbacks are no longer invoked, so keys and buttons held
+		//when closing would otherwise remain pressed when reopening
+		windowState.update([] (WindowState& state) { state.input = Window::InputState(); });
+
 		assert(!opened);
 	}
 
@@ -768,24 +1718,126 @@ struct WindowImpl {
 		assert(opened);
 		auto& window = owner.get();
 
-		if(hasChanged || window.layersHaveChanged()) {
-			opened->draw(window);
+		const auto layersHaveChanged = window.layersHaveChanged();
+		if(layersHaveChanged) {
+			pruneParallelLayers();
+		}
+
+		//Recreate the swapchain if the presentation engine has reported it as suboptimal
+		if(opened->isSwapchainOutdated()) {
+			recreateSwapchain();
+		}
+
+		//Inputs received until now can be shown, at the earliest, on this frame.
+		//If they do not cause it to be drawn, they are discarded. Otherwise, they
+		//would be attributed to an unrelated frame later on
+		const auto inputTime = inputLatencyMeasurement.load(std::memory_order_relaxed)
+			? pendingInputTime.exchange(TimePoint(), std::memory_order_relaxed)
+			: TimePoint();
+
+		if(hasChanged || layersHaveChanged) {
+			auto result = opened->draw(window, getAcquireTimeoutNanoseconds());
+
+			if(result == Open::DrawResult::outdated && recreateSwapchain()) {
+				//Try again with the new swapchain
+				result = opened->draw(window, getAcquireTimeoutNanoseconds());
+			}
+
+			if(result == Open::DrawResult::timeout && acquirePolicy == Window::AcquirePolicy::retry) {
+				//The frame will be late. Give it another chance within this update
+				++lateFrameCount;
+				result = opened->draw(window, getAcquireTimeoutNanoseconds());
+			}
+
+			if(inputTime != TimePoint() && result == Open::DrawResult::presented) {
+				//Tag this frame, so that its completion is measured
+				latencyProbes.push_back(LatencyProbe{
+					opened->lastPresentId,
+					inputTime,
+					opened->getLastSubmission()
+				});
+			}
+
+			switch(result) {
+			case Open::DrawResult::timeout:
+				//Nothing was presented on this update. Changes have already been 
+				//consumed, so keep the redraw pending for the next one
+				++skippedFrameCount;
+				hasChanged = true;
+				break;
+
+			case Open::DrawResult::outdated:
+				//Swapchain could not be recreated (i.e. minimized). Try again later
+				hasChanged = true;
+				break;
+
+			default:
+				hasChanged = false;
+				break;
+			}
+		}
+
+		//Report the frames that have reached the display
+		if(opened->hasPresentTiming()) {
+			opened->updatePresentTimings();
+			resolveLatencyProbes(opened->presentTimings);
+
+			if(callbacks.presentTimingCbk) {
+				for(const auto& timing : opened->presentTimings) {
+					queueEvent(
+						timing.presentTime,
+						std::bind(invokeIf, std::cref(callbacks.presentTimingCbk), std::ref(window), timing)
+					);
+				}
+			}
+			opened->presentTimings.clear();
+
+			if(framePacing) {
+				updateFramePacing();
+			}
 
-			hasChanged = false;
+			//The refresh rate may be known more accurately now. Evaluate it on
+			//every update, so that hysteresis counts updates with present timing
+			refreshPeriod = opened->getRefreshPeriod();
+			updateRefreshRate(REFRESH_RATE_HYSTERESIS);
+		} else if(!latencyProbes.empty()) {
+			//Without present timing, use the end of the rendering. As fences are only
+			//polled on updates, this is an upper bound with that granularity
+			resolveLatencyProbes();
 		}
 	}
 
+	void resolveLatencyProbes(const std::vector<Window::PresentTiming>& timings) {
+		for(const auto& timing : timings) {
+			//Probed frames which have been replaced are displayed with this one
+			auto ite = latencyProbes.begin();
+			for(; ite != latencyProbes.end() && ite->presentId <= timing.frameId; ++ite) {
+				inputLatencyHistogram.record(timing.presentTime - ite->inputTime);
+			}
+			latencyProbes.erase(latencyProbes.begin(), ite);
+		}
+	}
+
+	void resolveLatencyProbes() {
+		//Poll the fences without blocking. Probes are sorted by submission. The
+		//time at which they were signaled is unknown, so the current one is used
+		const auto now = Clock::now();
+		auto ite = latencyProbes.begin();
+		for(; ite != latencyProbes.end() && opened->isSubmissionCompleted(ite->submission); ++ite) {
+			inputLatencyHistogram.record(now - ite->inputTime);
+		}
+		latencyProbes.erase(latencyProbes.begin(), ite);
+	}
+
 	std::vector<VideoMode> getVideoModeCompatibility() const {
 		std::vector<VideoMode> result;
 
 		if(opened) {
-			//Select a monitor to depend on
-			const auto& mon = (monitor != Window::Monitor()) ? monitor : Window::getPrimaryMonitor();
-
-			//Construct a base capability struct which will be common to all compatibilities
+			//Construct a base capability struct which will be common to all compatibilities.
+			//Rates up to the actual refresh rate of the monitor are allowed
 			const VideoMode baseCompatibility(
-				Utils::Range<Rate>(Rate(0, 1), Rate(mon.getMode().frameRate, 1)),
-				Utils::MustBe<Resolution>(opened->window.getResolution()),
+				Utils::Range<Rate>(Rate(0, 1), getRefreshRate()),
+				Utils::MustBe<Resolution>(windowState.load().resolution),
 				Utils::MustBe<AspectRatio>(AspectRatio(1, 1)),
 				Utils::Any<ColorPrimaries>(),
 				Utils::MustBe<ColorModel>(ColorModel::rgb),
@@ -796,9 +1848,7 @@ struct WindowImpl {
 			);
 
 			//Query for full compatibility
-			Window& win = owner.get();
-			const auto& vulkan = win.getInstance().getVulkan();
-			const auto surfaceFormats = vulkan.getPhysicalDevice().getSurfaceFormatsKHR(*(opened->surface), vulkan.getDispatcher());
+			const auto& surfaceFormats = opened->getSurfaceFormats();
 
 			for(const auto& surfaceFormat : surfaceFormats) {
 				const auto [colorPrimary, colorTransferFunction] = Graphics::fromVulkan(surfaceFormat.colorSpace);
@@ -870,7 +1920,10 @@ struct WindowImpl {
 		if(size != s) {
 			size = s;
 			if(opened) {
-				opened->window.setSize(size);
+				//Apply it synchronously, so that the new resolution is known
+				GLFW::WindowTransaction transaction;
+				transaction.size = size;
+				applyTransaction(opened->window, transaction);
 				owner.get().setVideoModeCompatibility(getVideoModeCompatibility()); //This will call reconfigure if resizeing is needed
 			}
 		}
@@ -897,7 +1950,7 @@ struct WindowImpl {
 	}
 
 	Math::Vec2i getPosition() const {
-		return position;
+		return opened ? windowState.load().position : position;
 	}
 
 	void setPositionCallback(Window::PositionCallback cbk) {
@@ -910,7 +1963,7 @@ struct WindowImpl {
 
 
 	Math::Vec2f getScale() const {
-		return opened ? opened->window.getScale() : Math::Vec2f(0.0f);
+		return opened ? windowState.load().scale : Math::Vec2f(0.0f);
 	}
 
 	void setScaleCallback(Window::ScaleCallback cbk) {
@@ -957,7 +2010,9 @@ struct WindowImpl {
 
 	void setDecorated(bool deco) {
 		decorated = deco;
-		if(opened) opened->window.setDecorated(decorated);
+
+		//Borderless windows restore it when becoming windowed
+		if(opened && !isBorderless()) opened->window.setDecorated(decorated);
 	}
 
 	bool getDecorated() const {
@@ -980,7 +2035,7 @@ struct WindowImpl {
 	}
 
 	bool isIconified() const {
-		return opened ? opened->window.isIconified() : false;
+		return opened ? windowState.load().iconified : false;
 	}
 
 	void setIconifyCallback(Window::IconifyCallback cbk) {
@@ -997,7 +2052,7 @@ struct WindowImpl {
 	}
 
 	bool isMaximized() const {
-		return opened ? opened->window.isMaximized() : false;
+		return opened ? windowState.load().maximized : false;
 	}
 
 	void setMaximizeCallback(Window::MaximizeCallback cbk) {
@@ -1013,6 +2068,10 @@ struct WindowImpl {
 		if(opened) opened->window.focus();
 	}
 
+	bool isFocused() const {
+		return opened ? windowState.load().focused : false;
+	}
+
 	void setFocusCallback(Window::FocusCallback cbk) {
 		callbacks.focusCbk = std::move(cbk);
 	}
@@ -1028,15 +2087,23 @@ struct WindowImpl {
 
 
 	void setMonitor(const Window::Monitor& mon, const Window::Monitor::Mode* mode) {
-		monitor = mon;
+		//Disconnected monitors are ignored, so that it becomes windowed.
+		//When no mode is given, it covers the monitor without changing its mode
+		const auto handle = getMonitorHandle(mon);
+		monitor = handle ? mon : Window::NO_MONITOR;
+		borderless = (mode == nullptr);
 
 		if(opened) {
-			opened->window.setMonitor(
-				reinterpret_cast<const GLFW::Monitor&>(monitor), 
+			GLFW::WindowTransaction transaction;
+			transaction.monitor = GLFW::WindowMonitorChange {
+				handle, 
 				reinterpret_cast<const GLFW::VideoMode*>(mode)
-			);
+			};
+			if(!handle) transaction.decorated = decorated; //Borderless windows are undecorated
 
-			size = opened->window.getSize();
+			size = applyTransaction(opened->window, transaction).size;
+			opened->invalidateSurfaceProperties(); //i.e. exclusive fullscreen may have changed
+			updateOccupiedMonitor();
 			owner.get().setVideoModeCompatibility(getVideoModeCompatibility()); //This will call reconfigure if resizeing is needed
 		}
 	}
@@ -1045,12 +2112,270 @@ struct WindowImpl {
 		return monitor;
 	}
 
+	bool isBorderless() const noexcept {
+		return borderless && monitor != Window::NO_MONITOR;
+	}
 
 
-	KeyEvent getKeyState(KeyboardKey key) const {
+	void setLatencyProfile(Window::LatencyProfile profile) {
+		latencyProfile = profile;
+
+		//Frames in flight are left as set by the user, as several of them are
+		//only safe when layers do not rewrite their resources every frame
+		presentMode = getProfilePresentMode(latencyProfile);
+		extraImageCount = getProfileExtraImageCount(latencyProfile);
+		updateSwapchainParameters();
+	}
+
+	Window::LatencyProfile getLatencyProfile() const {
+		return latencyProfile;
+	}
+
+	size_t getExpectedFrameLatency() const {
+		//Frames waiting for the GPU
+		size_t result = framesInFlight;
+
+		//Frames waiting for the display. Use the mode actually in use, as
+		//the requested one falls back when unsupported
+		const auto activePresentMode = (opened && opened->getImageCount())
+			? fromVulkan(opened->getActivePresentMode()).value_or(Window::PresentMode::fifo)
+			: presentMode;
+
+		switch(activePresentMode) {
+		case Window::PresentMode::immediate:
+			break;
+
+		case Window::PresentMode::mailbox:
+			result += 1; //Only the newest image is queued
+			break;
+
+		default: //fifo-like
+			{
+				//Assume the usual minimum of 2 images when the swapchain is not created
+				const size_t imageCount = (opened && opened->getImageCount()) 
+					? opened->getImageCount() 
+					: 2 + extraImageCount;
+				result += imageCount - 1; //All but the one being scanned-out may be queued
+			}
+			break;
+		}
+
+		return result;
+	}
+
+
+	void setPresentMode(Window::PresentMode mode) {
+		if(presentMode != mode) {
+			presentMode = mode;
+			updateSwapchainParameters();
+		}
+	}
+
+	Window::PresentMode getPresentMode() const {
+		return presentMode;
+	}
+
+	std::vector<Window::PresentMode> getPresentModeCompatibility() const {
+		std::vector<Window::PresentMode> result;
+
+		if(opened) {
+			const auto& presentModes = opened->getPresentModes();
+			result.reserve(presentModes.size());
+
+			for(const auto& mode : presentModes) {
+				const auto conversion = fromVulkan(mode);
+				if(conversion) {
+					result.push_back(conversion.value());
+				}
+			}
+		}
+
+		return result;
+	}
+
+
+	void setMaxFramesInFlight(size_t count) {
+		framesInFlight = std::max(count, static_cast<size_t>(1));
+		if(opened && opened->frames.size() != framesInFlight) {
+			//Probed submissions belong to the frames being destroyed
+			latencyProbes.clear();
+			opened->setFrameCount(framesInFlight);
+		}
+	}
+
+	size_t getMaxFramesInFlight() const {
+		return framesInFlight;
+	}
+
+
+	void setParallelRecording(bool ena) {
+		parallelRecording = ena;
+		if(opened) opened->setParallelRecording(parallelRecording);
+	}
+
+	bool getParallelRecording() const {
+		return parallelRecording;
+	}
+
+	void setParallelRecording(const LayerBase& layer, bool ena) {
+		//Enabling it states that the layer can be drawn from any thread, concurrently
+		//with other layers, and without going through RendererBase::draw(). It only
+		//lasts while the layer is being rendered, as layers are identified by address
+		if(ena) {
+			parallelLayers.insert(&layer);
+		} else {
+			parallelLayers.erase(&layer);
+		}
+	}
+
+	bool getParallelRecording(const LayerBase& layer) const {
+		return parallelLayers.count(&layer) > 0;
+	}
+
+	void pruneParallelLayers() {
+		//Forget removed layers, so that a new layer allocated 
+		//at the same address does not inherit their opt-in
+		const auto& layers = owner.get().getLayers();
+		for(auto ite = parallelLayers.begin(); ite != parallelLayers.end(); ) {
+			const auto found = std::any_of(
+				layers.cbegin(), layers.cend(),
+				[layer = *ite] (const auto& l) -> bool {
+					return &static_cast<const LayerBase&>(l) == layer;
+				}
+			);
+
+			ite = found ? std::next(ite) : parallelLayers.erase(ite);
+		}
+	}
+
+
+	void setAcquireTimeout(Duration timeout) {
+		acquireTimeout = timeout;
+	}
+
+	Duration getAcquireTimeout() const {
+		return acquireTimeout;
+	}
+
+	void setAcquirePolicy(Window::AcquirePolicy policy) {
+		acquirePolicy = policy;
+	}
+
+	Window::AcquirePolicy getAcquirePolicy() const {
+		return acquirePolicy;
+	}
+
+	size_t getSkippedFrameCount() const {
+		return skippedFrameCount;
+	}
+
+	size_t getLateFrameCount() const {
+		return lateFrameCount;
+	}
+
+	void resetFrameCounters() {
+		skippedFrameCount = 0;
+		lateFrameCount = 0;
+	}
+
+
+	void setFramePacing(bool ena) {
+		if(framePacing != ena) {
+			framePacing = ena;
+
+			if(opened) {
+				opened->setFramePacing(framePacing);
+
+				//Go back to the nominal frame period
+				if(!framePacing) {
+					const auto& videoMode = owner.get().getVideoMode();
+					if(videoMode) {
+						schedulePeriodicUpdate(getPeriod(videoMode.getFrameRateValue()));
+					}
+				}
+			}
+		}
+	}
+
+	bool getFramePacing() const {
+		return framePacing;
+	}
+
+	bool getPresentTimingSupport() const {
+		return opened ? opened->hasPresentTiming() : false;
+	}
+
+	Duration getRefreshPeriod() const {
+		return opened ? opened->getRefreshPeriod() : Duration::zero();
+	}
+
+	void setPresentTimingCallback(Window::PresentTimingCallback cbk) {
+		callbacks.presentTimingCbk = std::move(cbk);
+	}
+
+	const Window::PresentTimingCallback& getPresentTimingCallback() const {
+		return callbacks.presentTimingCbk;
+	}
+
+
+	void setTimestampQueries(bool ena) {
+		timestampQueries = ena;
+		if(opened) opened->setTimestampQueries(timestampQueries);
+	}
+
+	bool getTimestampQueries() const {
+		return timestampQueries;
+	}
+
+	Window::GPUTimings getGPUTimings() const {
+		return opened ? opened->getGPUTimings() : Window::GPUTimings{};
+	}
+
+	void resetGPUTimings() {
+		if(opened) opened->resetGPUTimings();
+	}
+
+
+	Window::DurationHistogram getFramePhaseHistogram(Window::FramePhase phase) const {
+		return toDurationHistogram(phaseHistograms[static_cast<size_t>(phase)]);
+	}
+
+	void resetFramePhaseHistograms() {
+		for(auto& histogram : phaseHistograms) {
+			histogram.reset();
+		}
+	}
+
+
+	void setInputLatencyMeasurement(bool ena) {
+		if(inputLatencyMeasurement.exchange(ena, std::memory_order_relaxed) != ena) {
+			pendingInputTime.store(TimePoint(), std::memory_order_relaxed);
+			latencyProbes.clear();
+		}
+	}
+
+	bool getInputLatencyMeasurement() const {
+		return inputLatencyMeasurement.load(std::memory_order_relaxed);
+	}
+
+	Window::DurationHistogram getInputLatencyHistogram() const {
+		return toDurationHistogram(inputLatencyHistogram);
+	}
+
+	void resetInputLatencyHistogram() {
+		inputLatencyHistogram.reset();
+	}
+
+
+
+	Window::InputState getInputState() const {
 		return opened 
-		? fromGLFW(opened->window.getKeyState(toGLFW(key))) 
-		: KeyEvent::release;
+		? windowState.load().input
+		: Window::InputState();
+	}
+
+	KeyEvent getKeyState(KeyboardKey key) const {
+		return getInputState().getKeyState(key);
 	}
 
 	void setKeyboardCallback(Window::KeyboardCallback cbk) {
@@ -1072,9 +2397,7 @@ struct WindowImpl {
 
 
 	KeyEvent getMouseButtonState(MouseKey but) const {
-		return opened 
-		? fromGLFW(opened->window.getMouseButtonState(toGLFW(but)))
-		: KeyEvent::release;
+		return getInputState().getMouseButtonState(but);
 	}
 
 	void setMouseButtonCallback(Window::MouseButtonCallback cbk) {
@@ -1088,7 +2411,7 @@ struct WindowImpl {
 	
 	Math::Vec2d getMousePosition() const {
 		return opened 
-		? opened->window.getMousePosition()
+		? windowState.load().input.getMousePosition()
 		: Math::Vec2d();
 	}
 
@@ -1101,6 +2424,37 @@ struct WindowImpl {
 	}
 
 
+	void setRawMouseMotion(bool ena) {
+		if(rawMouseMotion.exchange(ena, std::memory_order_relaxed) != ena) {
+			//Discard the motion accumulated until now
+			mouseMotion.store(0, std::memory_order_relaxed);
+
+			if(opened) {
+				//Relative motion requires the cursor to be disabled. If raw 
+				//motion is not supported, accelerated motion will be reported
+				opened->window.setCursorMode(ena ? GLFW::CursorMode::disabled : GLFW::CursorMode::normal);
+				opened->window.setRawMouseMotion(ena);
+			}
+		}
+	}
+
+	bool getRawMouseMotion() const {
+		return rawMouseMotion.load(std::memory_order_relaxed);
+	}
+
+	bool getRawMouseMotionSupport() const {
+		return GLFW::Window::isRawMouseMotionSupported();
+	}
+
+	Math::Vec2d consumeMouseMotion() {
+		const auto motion = unpackMouseMotion(mouseMotion.exchange(0, std::memory_order_acquire));
+		return Math::Vec2d(
+			motion.x / MOUSE_MOTION_SCALE,
+			motion.y / MOUSE_MOTION_SCALE
+		);
+	}
+
+
 	void setMouseScrollCallback(Window::MouseScrollCallback cbk) {
 		callbacks.mouseScrollCbk = std::move(cbk);
 	}
@@ -1119,18 +2473,45 @@ struct WindowImpl {
 	}
 
 
+	TimePoint getEventTimestamp() const {
+		return eventTimestamp;
+	}
+
+
+	void setInputCoalescing(bool ena) {
+		inputCoalescing.store(ena, std::memory_order_relaxed);
+	}
+
+	bool getInputCoalescing() const {
+		return inputCoalescing.load(std::memory_order_relaxed);
+	}
+
+	uint64_t getCoalescedEventCount() const {
+		return coalescedEventCount.load(std::memory_order_relaxed);
+	}
+
+	uint64_t getEventOverflowCount() const {
+		return eventOverflowCount.load(std::memory_order_relaxed);
+	}
+
+
 
 	static Window::Monitor getPrimaryMonitor() {
-		const auto monitor = GLFW::Monitor::getPrimaryMonitor();
-		return reinterpret_cast<const Window::Monitor&>(monitor);
+		//Served from the registry, so no round-trip is needed
+		const auto monitors = GLFW::Monitor::getMonitors();
+		return monitors->empty() ? Window::NO_MONITOR : makeMonitor(monitors->front());
 	}
 
-	static Utils::BufferView<const Window::Monitor> getMonitors() {
+	static std::vector<Window::Monitor> getMonitors() {
 		const auto monitors = GLFW::Monitor::getMonitors();
-		return Utils::BufferView<const Window::Monitor>(
-			reinterpret_cast<const Window::Monitor*>(monitors.data()),
-			monitors.size()
-		);
+
+		std::vector<Window::Monitor> result;
+		result.reserve(monitors->size());
+		for(const auto& info : *monitors) {
+			result.push_back(makeMonitor(info));
+		}
+
+		return result;
 	}
 
 private:
@@ -1142,6 +2523,7 @@ private:
 
 		if(opened) {
 			window.disablePeriodicUpdate();
+			scheduledPeriod = Duration::zero();
 
 			if(videoMode) {
 				const auto frameDesc = videoMode.getFrameDescriptor();
@@ -1155,10 +2537,12 @@ private:
 					colorSpace, 
 					std::move(colorTransfer), 
 					depthStencil,
+					toVulkan(presentMode),
+					extraImageCount,
 					window.getCamera()
 				);
 
-				window.enablePeriodicUpdate(PRIORITY, framePeriod);
+				schedulePeriodicUpdate(framePeriod);
 			} else {
 				//Unset the stuff
 				opened->recreate(
@@ -1167,6 +2551,8 @@ private:
 					static_cast<vk::ColorSpaceKHR>(-1), 
 					Graphics::ColorTransferWrite(), 
 					DepthStencilFormat::none,
+					toVulkan(presentMode),
+					extraImageCount,
 					window.getCamera()
 				);
 			}
@@ -1179,224 +2565,849 @@ private:
 		}
 	}
 
-	void updateVideoMode() {
-		auto& window = owner.get();
-		window.setVideoModeCompatibility(getVideoModeCompatibility());
+	static constexpr vk::PresentModeKHR toVulkan(Window::PresentMode mode) noexcept {
+		switch(mode) {
+		case Window::PresentMode::immediate:	return vk::PresentModeKHR::eImmediate;
+		case Window::PresentMode::mailbox:		return vk::PresentModeKHR::eMailbox;
+		case Window::PresentMode::fifoRelaxed:	return vk::PresentModeKHR::eFifoRelaxed;
+		default:								return vk::PresentModeKHR::eFifo;
+		}
+	}
+
+	static constexpr std::optional<Window::PresentMode> fromVulkan(vk::PresentModeKHR mode) noexcept {
+		switch(mode) {
+		case vk::PresentModeKHR::eImmediate:	return Window::PresentMode::immediate;
+		case vk::PresentModeKHR::eMailbox:		return Window::PresentMode::mailbox;
+		case vk::PresentModeKHR::eFifo:			return Window::PresentMode::fifo;
+		case vk::PresentModeKHR::eFifoRelaxed:	return Window::PresentMode::fifoRelaxed;
+		default:								return {};
+		}
+	}
+
+	static Window::DurationHistogram toDurationHistogram(const AtomicHistogram& histogram) {
+		static_assert(Window::DurationHistogram::BUCKET_COUNT == AtomicHistogram::BUCKET_COUNT, "Bucket count mismatch");
+		Window::DurationHistogram result;
+
+		for(size_t i = 0; i < result.buckets.size(); ++i) {
+			result.buckets[i] = histogram.getBucket(i);
+		}
+		result.sampleCount = histogram.getSampleCount();
+		result.total = histogram.getTotal();
+		result.max = histogram.getMax();
+
+		return result;
+	}
+
+	void schedulePeriodicUpdate(Duration period) {
+		owner.get().enablePeriodicUpdate(PRIORITY, period);
+		scheduledPeriod = period;
+	}
+
+	void updateFramePacing() {
+		assert(opened);
+		const auto refreshPeriod = opened->getRefreshPeriod();
+		const auto& videoMode = owner.get().getVideoMode();
+
+		if(refreshPeriod <= Duration::zero() || !videoMode) {
+			return; //Nothing to align to
+		}
+
+		//Find the closest whole amount of refresh cycles
+		const auto framePeriod = getPeriod(videoMode.getFrameRateValue());
+		const auto cycles = std::max(
+			std::llround(static_cast<double>(framePeriod.count()) / refreshPeriod.count()), 
+			1LL
+		);
+		const auto alignedPeriod = refreshPeriod * cycles;
+
+		//Only align when the display is meant to show this rate (1% tolerance)
+		const auto error = (alignedPeriod > framePeriod) ? alignedPeriod - framePeriod : framePeriod - alignedPeriod;
+		const auto period = (error * 100 < framePeriod) ? alignedPeriod : framePeriod;
+
+		//Avoid rescheduling for negligible differences
+		const auto difference = (period > scheduledPeriod) ? period - scheduledPeriod : scheduledPeriod - period;
+		if(difference * 10000 > period) {
+			//This is called from the periodic update itself, so defer it. Ignore it
+			//if the schedule has been changed meanwhile (i.e. recreated or disabled)
+			const auto expected = scheduledPeriod;
+			queueEvent(
+				Clock::now(),
+				[this, period, expected] {
+					if(opened && framePacing && scheduledPeriod == expected) {
+						schedulePeriodicUpdate(period);
+					}
+				}
+			);
+		}
+	}
+
+	uint64_t getAcquireTimeoutNanoseconds() const {
+		if(acquireTimeout == Duration::max()) {
+			return Graphics::Vulkan::NO_TIMEOUT;
+		} else if(acquireTimeout <= Duration::zero()) {
+			return 0;
+		} else {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(acquireTimeout).count();
+		}
+	}
+
+	void updateSwapchainParameters() {
+		if(opened) {
+			auto& window = owner.get();
+			opened->setSwapchainParameters(toVulkan(presentMode), extraImageCount, window.getCamera());
+
+			//Extent might have changed when recreating the swapchain
+			window.setViewportSize(Graphics::fromVulkan(opened->extent));
+			window.setRenderPass(opened->renderPass.get());
+			hasChanged = true;
+		}
+	}
+
+	bool recreateSwapchain() {
+		assert(opened);
+		auto& window = owner.get();
+
+		//Use the current size of the framebuffer
+		const auto extent = Graphics::toVulkan(windowState.load().resolution);
+		if(extent.width == 0 || extent.height == 0) {
+			return false; //Nothing to present to
+		}
+
+		const auto oldExtent = opened->extent;
+		opened->recreateSwapchain(extent, window.getCamera());
+
+		//Update the viewport size and the renderpass
+		window.setViewportSize(Graphics::fromVulkan(opened->extent));
+		window.setRenderPass(opened->renderPass.get());
+		hasChanged = true;
+
+		if(opened->extent != oldExtent) {
+			//Renegotiate the video mode outside the update, as the resolution has changed
+			queueEvent(Clock::now(), std::bind(&WindowImpl::updateVideoMode, std::ref(*this)));
+		}
+
+		return static_cast<bool>(opened->swapchain);
+	}
+
+	static constexpr Window::PresentMode getProfilePresentMode(Window::LatencyProfile profile) noexcept {
+		switch(profile) {
+		case Window::LatencyProfile::lowestLatency:	return Window::PresentMode::immediate;
+		case Window::LatencyProfile::smoothest:		return Window::PresentMode::fifo;
+		default:									return Window::PresentMode::mailbox;
+		}
+	}
+
+	static constexpr uint32_t getProfileExtraImageCount(Window::LatencyProfile profile) noexcept {
+		switch(profile) {
+		case Window::LatencyProfile::lowestLatency:	return 0;
+		case Window::LatencyProfile::smoothest:		return 2;
+		default:									return 1;
+		}
+	}
+
+	void updateVideoMode() {
+		auto& window = owner.get();
+		window.setVideoModeCompatibility(getVideoModeCompatibility());
+	}
+
+	static std::tuple<vk::Extent2D, vk::Format, vk::ColorSpaceKHR, Graphics::ColorTransferWrite>
+	convertParameters(	const Graphics::Vulkan& vulkan,
+						const Graphics::Frame::Descriptor& frameDescriptor )
+	{
+		//Obtain the pixel format
+		auto planes = frameDescriptor.getPlanes();
+		assert(planes.size() == 1);
+
+		auto& plane = planes.front();
+		const auto[format, swizzle] = Graphics::optimizeFormat(std::make_tuple(plane.getFormat(), plane.getSwizzle()));
+		plane.setFormat(format);
+		plane.setSwizzle(swizzle);
+		assert(plane.getSwizzle() == vk::ComponentMapping());
+
+		//Obtain the color space
+		const auto colorSpace = Graphics::toVulkan(
+			frameDescriptor.getColorPrimaries(), 
+			frameDescriptor.getColorTransferFunction()
+		);
+
+		//Create the color transfer characteristics
+		Graphics::ColorTransferWrite colorTransfer(frameDescriptor);
+
+		constexpr vk::FormatFeatureFlags DESIRED_FLAGS = 
+			vk::FormatFeatureFlagBits::eColorAttachment;
+		const auto& supportedFormats = vulkan.listSupportedFormatsOptimal(DESIRED_FLAGS);
+		colorTransfer.optimize(planes, supportedFormats);
+
+		return std::make_tuple(
+			Graphics::to2D(plane.getExtent()), 
+			plane.getFormat(), 
+			colorSpace, 
+			std::move(colorTransfer)
+		);
+	}
+
+
+	GLFW::WindowState applyTransaction(GLFW::Window& win, GLFW::WindowTransaction transaction) {
+		//Callbacks may have been invoked meanwhile. In that case, query it again,
+		//as they are written from the GLFW thread and they might be newer
+		GLFW::WindowState state;
+		WindowState newState;
+		AtomicSnapshot<WindowState>::Version version;
+
+		do {
+			version = windowState.getVersion();
+			newState = windowState.load(); //Input state is only written by callbacks
+			state = win.apply(transaction);
+			transaction = GLFW::WindowTransaction(); //Only query when retrying
+
+			newState.position = state.position;
+			newState.size = state.size;
+			newState.resolution = state.resolution;
+			newState.scale = state.scale;
+			newState.input.m_mousePosition = state.mousePosition;
+			newState.focused = state.focused;
+			newState.iconified = state.iconified;
+			newState.maximized = state.maximized;
+		} while(!windowState.compareAndStore(version, newState));
+
+		return state;
+	}
+
+	template<typename T>
+	static void setBit(T& word, size_t index, bool value) noexcept {
+		const auto mask = T(1) << index;
+		word = value ? (word | mask) : (word & ~mask);
+	}
+
+	static Window::Monitor makeMonitor(std::shared_ptr<const GLFW::MonitorInfo> info) noexcept {
+		Window::Monitor result;
+		result.m_info = std::move(info);
+		return result;
+	}
+
+	static GLFW::MonitorId getMonitorId(const Window::Monitor& mon) noexcept {
+		const auto* info = static_cast<const GLFW::MonitorInfo*>(mon.m_info.get());
+		return info ? info->id : GLFW::NO_MONITOR_ID;
+	}
+
+	static GLFW::Monitor getMonitorHandle(const Window::Monitor& mon) {
+		//Resolves to a null handle if it has been disconnected
+		return GLFW::Monitor::fromId(getMonitorId(mon));
+	}
+
+	static void addMonitorListener(WindowImpl& impl) {
+		std::lock_guard<std::mutex> lock(s_monitorListenersMutex);
+		s_monitorListeners.push_back(&impl);
+
+		//Idempotent, as it is always the same callback
+		GLFW::Monitor::setMonitorCallback(monitorCallback);
+	}
+
+	static void removeMonitorListener(WindowImpl& impl) {
+		std::lock_guard<std::mutex> lock(s_monitorListenersMutex);
+		const auto ite = std::find(s_monitorListeners.cbegin(), s_monitorListeners.cend(), &impl);
+		assert(ite != s_monitorListeners.cend());
+		s_monitorListeners.erase(ite);
+	}
+
+	static void monitorCallback(GLFW::MonitorHandle, GLFW::MonitorId id, GLFW::MonitorEvent event) {
+		//Called from the GLFW thread. All opened windows are notified, as even
+		//if their monitor is not affected, the primary monitor may have changed
+		std::lock_guard<std::mutex> lock(s_monitorListenersMutex);
+		for(auto* impl : s_monitorListeners) {
+			impl->pushEvent(Event::monitor(id, event));
+		}
+	}
+
+	static WindowImpl& getUserPointer(GLFW::WindowHandle win) {
+		auto* usrPtr = static_cast<WindowImpl*>(GLFW::Instance::get().getUserPointer(win));
+		assert(usrPtr);
+		return *usrPtr;
+	}
+
+	static size_t getEmitterId(const WindowImpl& impl) {
+		return reinterpret_cast<uintptr_t>(&impl);
+	}
+
+	static constexpr auto invokeIf = [] (auto&& f, auto&& ...params) {
+		Utils::invokeIf(std::forward<decltype(f)>(f), std::forward<decltype(params)>(params)...);
+	};
+
+	static void windowPositionCallback(GLFW::WindowHandle win, int x, int y) {
+		auto& impl = getUserPointer(win);
+		GLFW::Monitor::refreshMonitors(); //Monitors may have been rearranged
+		impl.windowState.update([&] (WindowState& state) { state.position = Math::Vec2i(x, y); });
+		impl.pushEvent(Event::position(x, y));
+	}
+
+	static void windowSizeCallback(GLFW::WindowHandle win, int x, int y) {
+		auto& impl = getUserPointer(win);
+		GLFW::Monitor::refreshMonitors(); //i.e. video mode changed by another application
+		impl.windowState.update([&] (WindowState& state) { state.size = Math::Vec2i(x, y); });
+		impl.pushEvent(Event::size(x, y));
+	}
+
+	static void windowShouldCloseCallback(GLFW::WindowHandle win) {
+		auto& impl = getUserPointer(win);
+		impl.pushEvent(Event::shouldClose());
+	}
+
+	static void windowRefreshCallback(GLFW::WindowHandle win) {
+		auto& impl = getUserPointer(win);
+		impl.pushEvent(Event::refresh());
+	}
+
+	static void windowFocusCallback(GLFW::WindowHandle win, int focus) {
+		auto& impl = getUserPointer(win);
+		impl.windowState.update([&] (WindowState& state) { state.focused = static_cast<bool>(focus); });
+		impl.pushEvent(Event::focus(focus));
+	}
+
+	static void windowIconifyCallback(GLFW::WindowHandle win, int iconify) {
+		auto& impl = getUserPointer(win);
+		impl.windowState.update([&] (WindowState& state) { state.iconified = static_cast<bool>(iconify); });
+		impl.pushEvent(Event::iconify(iconify));
+	}
+
+	static void windowMaximizeCallback(GLFW::WindowHandle win, int maximized) {
+		auto& impl = getUserPointer(win);
+		impl.windowState.update([&] (WindowState& state) { state.maximized = static_cast<bool>(maximized); });
+		impl.pushEvent(Event::maximize(maximized));
+	}
+
+	static void windowResolutionCallback(GLFW::WindowHandle win, int x, int y) {
+		auto& impl = getUserPointer(win);
+		impl.windowState.update([&] (WindowState& state) { state.resolution = Resolution(x, y); });
+	}
+
+	static void windowScaleCallback(GLFW::WindowHandle win, float x, float y) {
+		auto& impl = getUserPointer(win);
+		impl.windowState.update([&] (WindowState& state) { state.scale = Math::Vec2f(x, y); });
+		impl.pushEvent(Event::scale(x, y));
+	}
+
+	static void windowKeyCallback(	GLFW::WindowHandle win, 
+									GLFW::KeyboardKey key, 
+									int scancode, 
+									GLFW::KeyEvent event, 
+									GLFW::KeyModifiers modifiers)
+	{
+		auto& impl = getUserPointer(win);
+		impl.markInput();
+
+		impl.windowState.update(
+			[&] (WindowState& state) { 
+				if(key != GLFW::KeyboardKey::none) {
+					constexpr size_t WORD_BITS = std::numeric_limits<uint64_t>::digits;
+					const auto index = static_cast<size_t>(key);
+					assert(index / WORD_BITS < state.input.m_keys.size());
+					setBit(state.input.m_keys[index / WORD_BITS], index % WORD_BITS, event != GLFW::KeyEvent::release);
+				}
+				state.input.m_modifiers = fromGLFW(modifiers);
+			}
+		);
+
+		Utils::ignore(scancode); //TODO Not implemented
+		impl.pushEvent(Event::keyboard(key, event, modifiers));
+	}
+
+	static void windowCharCallback(GLFW::WindowHandle win, unsigned int character) {
+		auto& impl = getUserPointer(win);
+		impl.markInput();
+		impl.pushEvent(Event::character(character));
+	}
+
+	static void windowMousePositionCallback(GLFW::WindowHandle win, double x, double y) {
+		auto& impl = getUserPointer(win);
+		impl.markInput();
+
+		Math::Vec2d previous;
+		impl.windowState.update(
+			[&] (WindowState& state) { 
+				previous = state.input.m_mousePosition;
+				state.input.m_mousePosition = Math::Vec2d(x, y); 
+			}
+		);
+
+		if(impl.rawMouseMotion.load(std::memory_order_relaxed)) {
+			impl.accumulateMouseMotion(Math::Vec2d(x - previous.x, y - previous.y));
+		}
+
+		//When the ring is full, positions are coalesced even if not requested
+		if(	impl.inputCoalescing.load(std::memory_order_relaxed) ||
+			!impl.tryPushEvent(Event::mousePosition(x, y)) ) 
+		{
+			impl.coalesceMousePosition();
+		}
+	}
+
+	static void windowMouseEnterCallback(GLFW::WindowHandle win, int entered) {
+		auto& impl = getUserPointer(win);
+		impl.pushEvent(Event::mouseEnter(entered));
+	}
+
+	static void windowMouseButtonCallback(	GLFW::WindowHandle win, 
+											GLFW::MouseButton but,
+											GLFW::KeyEvent event, 
+											GLFW::KeyModifiers modifiers) 
+	{
+		auto& impl = getUserPointer(win);
+		impl.markInput();
+
+		impl.windowState.update(
+			[&] (WindowState& state) { 
+				setBit(state.input.m_mouseButtons, static_cast<size_t>(but), event != GLFW::KeyEvent::release);
+				state.input.m_modifiers = fromGLFW(modifiers);
+			}
+		);
+
+		impl.pushEvent(Event::mouseButton(but, event, modifiers));
+	}
+
+	static void windowMouseScrollCallback(GLFW::WindowHandle win, double x, double y) {
+		auto& impl = getUserPointer(win);
+		impl.markInput();
+		
+		//When the ring is full, scrolls are coalesced even if not requested
+		if(	impl.inputCoalescing.load(std::memory_order_relaxed) ||
+			!impl.tryPushEvent(Event::mouseScroll(x, y)) ) 
+		{
+			impl.coalesceMouseScroll(Math::Vec2d(x, y));
+		}
+	}
+
+	void coalesceMousePosition() {
+		//Coalesced events report the time of the latest sample
+		mousePositionTimestamp.store(Clock::now(), std::memory_order_relaxed);
+
+		//Only enqueue an event if there is none pending. It will report the latest position
+		if(!mousePositionPending.exchange(true, std::memory_order_acq_rel)) {
+			pushEvent(Event::coalescedMousePosition());
+		} else {
+			coalescedEventCount.fetch_add(1, std::memory_order_relaxed);
+		}
 	}
 
-	static std::tuple<vk::Extent2D, vk::Format, vk::ColorSpaceKHR, Graphics::ColorTransferWrite>
-	convertParameters(	const Graphics::Vulkan& vulkan,
-						const Graphics::Frame::Descriptor& frameDescriptor )
-	{
-		//Obtain the pixel format
-		auto planes = frameDescriptor.getPlanes();
-		assert(planes.size() == 1);
+	void coalesceMouseScroll(Math::Vec2d delta) {
+		//Accumulate the delta until the pending event is delivered
+		pendingMouseScroll.update([&] (Math::Vec2d& pending) { pending += delta; });
+		mouseScrollTimestamp.store(Clock::now(), std::memory_order_relaxed);
 
-		auto& plane = planes.front();
-		const auto[format, swizzle] = Graphics::optimizeFormat(std::make_tuple(plane.getFormat(), plane.getSwizzle()));
-		plane.setFormat(format);
-		plane.setSwizzle(swizzle);
-		assert(plane.getSwizzle() == vk::ComponentMapping());
+		if(!mouseScrollPending.exchange(true, std::memory_order_acq_rel)) {
+			pushEvent(Event::coalescedMouseScroll());
+		} else {
+			coalescedEventCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
 
-		//Obtain the color space
-		const auto colorSpace = Graphics::toVulkan(
-			frameDescriptor.getColorPrimaries(), 
-			frameDescriptor.getColorTransferFunction()
+	void accumulateMouseMotion(Math::Vec2d delta) {
+		//Only called from the GLFW thread. Convert it into fixed point, 
+		//keeping the rounding error for the next sample
+		constexpr double LIMIT = std::numeric_limits<int32_t>::max();
+		const Math::Vec2d total(
+			std::clamp((delta.x + mouseMotionResidual.x) * MOUSE_MOTION_SCALE, -LIMIT, LIMIT),
+			std::clamp((delta.y + mouseMotionResidual.y) * MOUSE_MOTION_SCALE, -LIMIT, LIMIT)
+		);
+		const Math::Vec2i fixed(
+			static_cast<int32_t>(std::round(total.x)),
+			static_cast<int32_t>(std::round(total.y))
+		);
+		mouseMotionResidual = Math::Vec2d(
+			(total.x - fixed.x) / MOUSE_MOTION_SCALE,
+			(total.y - fixed.y) / MOUSE_MOTION_SCALE
 		);
 
-		//Create the color transfer characteristics
-		Graphics::ColorTransferWrite colorTransfer(frameDescriptor);
-
-		constexpr vk::FormatFeatureFlags DESIRED_FLAGS = 
-			vk::FormatFeatureFlagBits::eColorAttachment;
-		const auto& supportedFormats = vulkan.listSupportedFormatsOptimal(DESIRED_FLAGS);
-		colorTransfer.optimize(planes, supportedFormats);
-
-		return std::make_tuple(
-			Graphics::to2D(plane.getExtent()), 
-			plane.getFormat(), 
-			colorSpace, 
-			std::move(colorTransfer)
+		//Add it to the accumulated motion, saturating it if the reader is late
+		const auto saturate = [] (int64_t x) -> int32_t {
+			return static_cast<int32_t>(std::clamp<int64_t>(
+				x, 
+				std::numeric_limits<int32_t>::min(), 
+				std::numeric_limits<int32_t>::max()
+			));
+		};
+
+		auto expected = mouseMotion.load(std::memory_order_relaxed);
+		uint64_t desired;
+		do {
+			const auto current = unpackMouseMotion(expected);
+			desired = packMouseMotion(Math::Vec2i(
+				saturate(static_cast<int64_t>(current.x) + fixed.x),
+				saturate(static_cast<int64_t>(current.y) + fixed.y)
+			));
+		} while(!mouseMotion.compare_exchange_weak(expected, desired, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	static uint64_t packMouseMotion(Math::Vec2i motion) noexcept {
+		return 	(static_cast<uint64_t>(static_cast<uint32_t>(motion.y)) << 32) | 
+				static_cast<uint64_t>(static_cast<uint32_t>(motion.x)) ;
+	}
+
+	static Math::Vec2i unpackMouseMotion(uint64_t motion) noexcept {
+		return Math::Vec2i(
+			static_cast<int32_t>(static_cast<uint32_t>(motion)),
+			static_cast<int32_t>(static_cast<uint32_t>(motion >> 32))
 		);
 	}
 
-
-	static WindowImpl& getUserPointer(GLFW::WindowHandle win) {
-		auto* usrPtr = static_cast<WindowImpl*>(GLFW::Instance::get().getUserPointer(win));
-		assert(usrPtr);
-		return *usrPtr;
+	void markInput() {
+		//Only the oldest input which has not been rendered yet is kept
+		if(inputLatencyMeasurement.load(std::memory_order_relaxed)) {
+			auto expected = TimePoint();
+			pendingInputTime.compare_exchange_strong(expected, Clock::now(), std::memory_order_relaxed);
+		}
 	}
 
-	static size_t getEmitterId(const WindowImpl& impl) {
-		return reinterpret_cast<uintptr_t>(&impl);
-	}
+	bool tryPushEvent(Event event) {
+		//Only called from the GLFW thread, so there is a single producer.
+		//Stamp it now, as it may be delivered much later. While events are
+		//being spilled, the ring is not used, so that the order is kept
+		event.timestamp = Clock::now();
+		if(eventOverflowed.load(std::memory_order_acquire) || !events.tryPush(event)) {
+			eventOverflowCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
 
-	static constexpr auto invokeIf = [] (auto&& f, auto&& ...params) {
-		Utils::invokeIf(std::forward<decltype(f)>(f), std::forward<decltype(params)>(params)...);
-	};
+		scheduleDrain();
+		return true;
+	}
 
-	static void windowPositionCallback(GLFW::WindowHandle win, int x, int y) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	void pushEvent(Event event) {
+		if(!tryPushEvent(event)) {
+			//The ring is full. Spill it, as these events must not be lost
+			event.timestamp = Clock::now();
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getPositionCallback()), std::ref(window), Math::Vec2i(x, y))
-		);
+			std::lock_guard<std::mutex> lock(eventOverflowMutex);
+			eventOverflow.push_back(event);
+			eventOverflowed.store(true, std::memory_order_release);
+			scheduleDrain();
+		}
 	}
 
-	static void windowSizeCallback(GLFW::WindowHandle win, int x, int y) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	void scheduleDrain() {
+		//Schedule a drain if there is none pending. The lambda only
+		//captures a pointer, so it does not allocate when type-erased
+		if(!eventsPending.exchange(true)) {
+			owner.get().getInstance().addEvent(
+				getEmitterId(*this),
+				[this] { drainEvents(); }
+			);
+		}
+	}
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getSizeCallback()), std::ref(window), Math::Vec2i(x, y))
+	template<typename Func>
+	void queueEvent(TimePoint timestamp, Func&& func) {
+		//Stamp them as the ones coming from GLFW, so that getEventTimestamp()
+		//does not report the time of a previous input inside these
+		owner.get().getInstance().addEvent(
+			getEmitterId(*this),
+			[this, timestamp, func = std::forward<Func>(func)] () mutable {
+				eventTimestamp = timestamp;
+				func();
+			}
 		);
 	}
 
-	static void windowShouldCloseCallback(GLFW::WindowHandle win) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	void drainEvents() {
+		//Clear the flag before popping, so that newer events schedule a new drain
+		eventsPending.store(false);
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getShouldCloseCallback()), std::ref(window))
-		);
-	}
+		Event event;
+		while(events.tryPop(event)) {
+			dispatchEvent(event);
+		}
 
-	static void windowRefreshCallback(GLFW::WindowHandle win) {
-		auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+		if(eventOverflowed.load(std::memory_order_acquire)) {
+			std::vector<Event> overflow;
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(&WindowImpl::updateVideoMode, std::ref(impl))
-		);
+			{
+				//Nothing is pushed to the ring while spilling, so the 
+				//events left on it are older than the spilled ones
+				std::lock_guard<std::mutex> lock(eventOverflowMutex);
+				while(events.tryPop(event)) {
+					overflow.push_back(event);
+				}
+				overflow.insert(overflow.cend(), eventOverflow.cbegin(), eventOverflow.cend());
+				eventOverflow.clear();
+				eventOverflowed.store(false, std::memory_order_release);
+			}
+
+			for(const auto& spilled : overflow) {
+				dispatchEvent(spilled);
+			}
+		}
 	}
 
-	static void windowFocusCallback(GLFW::WindowHandle win, int focus) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	void discardEvents() {
+		//Only when the GLFW window has been destroyed, so nothing is being pushed
+		Event event;
+		while(events.tryPop(event));
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getFocusCallback()), std::ref(window), focus)
-		);
+		{
+			std::lock_guard<std::mutex> lock(eventOverflowMutex);
+			eventOverflow.clear();
+			eventOverflowed.store(false);
+		}
+
+		eventsPending.store(false);
+		mousePositionPending.store(false);
+		mouseScrollPending.store(false);
 	}
 
-	static void windowIconifyCallback(GLFW::WindowHandle win, int iconify) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	void dispatchEvent(const Event& event) {
+		auto& window = owner.get();
+		const auto& payload = event.payload;
+
+		eventTimestamp = event.timestamp;
+
+		switch(event.type) {
+		case Event::Type::position:
+			updateOccupiedMonitor();
+			Utils::invokeIf(callbacks.positionCbk, window, Math::Vec2i(payload.integers[0], payload.integers[1]));
+			break;
+
+		case Event::Type::size:
+			updateOccupiedMonitor();
+			Utils::invokeIf(callbacks.sizeCbk, window, Math::Vec2i(payload.integers[0], payload.integers[1]));
+			break;
+
+		case Event::Type::shouldClose:
+			Utils::invokeIf(callbacks.shouldCloseCbk, window);
+			break;
+
+		case Event::Type::refresh:
+			updateVideoMode();
+			break;
+
+		case Event::Type::focus:
+			Utils::invokeIf(callbacks.focusCbk, window, static_cast<bool>(payload.integers[0]));
+			break;
+
+		case Event::Type::iconify:
+			Utils::invokeIf(callbacks.iconifyCbk, window, static_cast<bool>(payload.integers[0]));
+			break;
+
+		case Event::Type::maximize:
+			Utils::invokeIf(callbacks.maximizeCbk, window, static_cast<bool>(payload.integers[0]));
+			break;
+
+		case Event::Type::scale:
+			Utils::invokeIf(callbacks.scaleCbk, window, Math::Vec2f(payload.floats[0], payload.floats[1]));
+			break;
+
+		case Event::Type::keyboard:
+			Utils::invokeIf(
+				callbacks.keyboardCbk, window, 
+				fromGLFW(static_cast<GLFW::KeyboardKey>(payload.integers[0])), 
+				fromGLFW(static_cast<GLFW::KeyEvent>(payload.integers[1])), 
+				fromGLFW(static_cast<GLFW::KeyModifiers>(payload.integers[2]))
+			);
+			break;
+
+		case Event::Type::character:
+			Utils::invokeIf(callbacks.characterCbk, window, payload.character);
+			break;
+
+		case Event::Type::mousePosition:
+			Utils::invokeIf(callbacks.mousePositionCbk, window, Math::Vec2d(payload.doubles[0], payload.doubles[1]));
+			break;
+
+		case Event::Type::mouseEnter:
+			Utils::invokeIf(callbacks.cursorEnterCbk, window, static_cast<bool>(payload.integers[0]));
+			break;
+
+		case Event::Type::mouseButton:
+			Utils::invokeIf(
+				callbacks.mouseButtonCbk, window, 
+				fromGLFW(static_cast<GLFW::MouseButton>(payload.integers[0])), 
+				fromGLFW(static_cast<GLFW::KeyEvent>(payload.integers[1])), 
+				fromGLFW(static_cast<GLFW::KeyModifiers>(payload.integers[2]))
+			);
+			break;
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getIconifyCallback()), std::ref(window), iconify)
-		);
+		case Event::Type::mouseScroll:
+			Utils::invokeIf(callbacks.mouseScrollCbk, window, Math::Vec2d(payload.doubles[0], payload.doubles[1]));
+			break;
+
+		case Event::Type::coalescedMousePosition:
+			flushMousePosition();
+			break;
+
+		case Event::Type::coalescedMouseScroll:
+			flushMouseScroll();
+			break;
+
+		case Event::Type::monitor:
+			monitorChanged(payload.monitor.id, payload.monitor.event);
+			break;
+		}
 	}
 
-	static void windowMaximizeCallback(GLFW::WindowHandle win, int maximized) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	void monitorChanged(GLFW::MonitorId id, GLFW::MonitorEvent event) {
+		if(event == GLFW::MonitorEvent::disconnected && getMonitorId(monitor) == id) {
+			//Our monitor is gone. GLFW may have already made it windowed,
+			//but the saved windowed geometry still needs to be restored
+			monitor = Window::NO_MONITOR;
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getMaximizeCallback()), std::ref(window), maximized)
-		);
+			if(opened) {
+				GLFW::WindowTransaction transaction;
+				transaction.monitor = GLFW::WindowMonitorChange{ nullptr, nullptr };
+				transaction.decorated = decorated;
+				size = applyTransaction(opened->window, transaction).size;
+			}
+		}
+
+		//Refresh rate limits and surface properties may have changed
+		if(opened) {
+			opened->invalidateSurfaceProperties();
+			updateOccupiedMonitor();
+			owner.get().setVideoModeCompatibility(getVideoModeCompatibility());
+		}
 	}
 
-	static void windowScaleCallback(GLFW::WindowHandle win, float x, float y) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
-		
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getScaleCallback()), std::ref(window), Math::Vec2f(x, y))
-		);
+	GLFW::MonitorId findOccupiedMonitor() const {
+		const auto monitors = GLFW::Monitor::getMonitors();
+
+		//Fullscreen windows are always on their monitor
+		if(monitor != Window::NO_MONITOR) {
+			return getMonitorId(monitor);
+		}
+
+		//Otherwise, select the monitor with the largest overlap
+		const auto state = windowState.load();
+		GLFW::MonitorId result = GLFW::NO_MONITOR_ID;
+		int64_t maxArea = 0;
+
+		for(const auto& info : *monitors) {
+			const auto x0 = std::max(state.position.x, info->position.x);
+			const auto y0 = std::max(state.position.y, info->position.y);
+			const auto x1 = std::min(state.position.x + state.size.x, info->position.x + info->videoMode.size.x);
+			const auto y1 = std::min(state.position.y + state.size.y, info->position.y + info->videoMode.size.y);
+			const auto area = static_cast<int64_t>(std::max(x1 - x0, 0)) * std::max(y1 - y0, 0);
+
+			if(area > maxArea) {
+				result = info->id;
+				maxArea = area;
+			}
+		}
+
+		//When it is off-screen, assume the primary monitor
+		if(result == GLFW::NO_MONITOR_ID && !monitors->empty()) {
+			result = monitors->front()->id;
+		}
+
+		return result;
 	}
 
-	static void windowKeyCallback(	GLFW::WindowHandle win, 
-									GLFW::KeyboardKey key, 
-									int scancode, 
-									GLFW::KeyEvent event, 
-									GLFW::KeyModifiers modifiers)
-	{
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	void updateOccupiedMonitor() {
+		const auto newMonitor = findOccupiedMonitor();
+		if(newMonitor != occupiedMonitor) {
+			occupiedMonitor = newMonitor;
 
-		Utils::ignore(scancode); //TODO Not implemented
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getKeyboardCallback()), std::ref(window), fromGLFW(key), fromGLFW(event), fromGLFW(modifiers))
-		);
+			//The old measurement and surface properties belong to the previous monitor
+			if(opened) {
+				opened->resetRefreshPeriod();
+				opened->invalidateSurfaceProperties();
+				refreshPeriod = opened->getRefreshPeriod();
+			}
+		}
+
+		//The mode of the monitor may have changed even if it is the same one
+		updateRefreshRate();
 	}
 
-	static void windowCharCallback(GLFW::WindowHandle win, unsigned int character) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	void updateRefreshRate(size_t hysteresis = 0) {
+		const auto newRate = getRefreshRate();
+		if(newRate == refreshRate) {
+			refreshRateCandidateCount = 0;
+			return;
+		}
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getCharacterCallback()), std::ref(window), character)
-		);
+		//The measured period jitters, so it may alternate between neighbouring 
+		//rates. Only advertise a new one after it has been stable for a while
+		if(newRate != refreshRateCandidate) {
+			refreshRateCandidate = newRate;
+			refreshRateCandidateCount = 0;
+		}
+		if(++refreshRateCandidateCount < hysteresis) {
+			return;
+		}
+
+		refreshRate = newRate;
+		refreshRateCandidateCount = 0;
+
+		if(opened) {
+			//This might be called from the periodic update, so renegotiate outside it
+			queueEvent(Clock::now(), std::bind(&WindowImpl::updateVideoMode, std::ref(*this)));
+		}
 	}
 
-	static void windowMousePositionCallback(GLFW::WindowHandle win, double x, double y) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	Rate getRefreshRate() const {
+		//Prefer the measured refresh period, as it might not be an integer rate
+		if(refreshPeriod > Duration::zero()) {
+			const auto measured = 1.0 / std::chrono::duration_cast<std::chrono::duration<double>>(refreshPeriod).count();
+			const auto snapped = snapRefreshRate(measured);
+			if(snapped) {
+				return *snapped;
+			}
+		}
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getMousePositionCallback()), std::ref(window), Math::Vec2d(x, y))
-		);
+		//Otherwise derive it from the current mode of the monitor
+		const auto info = GLFW::Monitor::getInfo(occupiedMonitor);
+		return info ? getModeRefreshRate(info->videoMode.frameRate) : Rate(0, 1);
 	}
 
-	static void windowMouseEnterCallback(GLFW::WindowHandle win, int entered) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	static std::optional<Rate> snapRefreshRate(double rate) noexcept {
+		//Displays run at integer rates or at their NTSC variant (x1000/1001). 
+		//These are 0.1% apart, so only accept errors below 0.025%
+		constexpr double TOLERANCE = 2.5e-4;
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getCursorEnterCallback()), std::ref(window), entered)
-		);
+		const auto integer = std::round(rate);
+		if(integer > 0 && std::abs(rate - integer) < integer * TOLERANCE) {
+			return Rate(static_cast<int64_t>(integer), 1);
+		}
+
+		const auto ntsc = std::round(rate * 1.001);
+		if(ntsc > 0 && std::abs(rate - ntsc / 1.001) < ntsc * TOLERANCE) {
+			return Rate(static_cast<int64_t>(ntsc) * 1000, 1001);
+		}
+
+		return std::nullopt;
 	}
 
-	static void windowMouseButtonCallback(	GLFW::WindowHandle win, 
-											GLFW::MouseButton but,
-											GLFW::KeyEvent event, 
-											GLFW::KeyModifiers modifiers) 
-	{
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
+	static Rate getModeRefreshRate(int frameRate) noexcept {
+		//Some platforms truncate NTSC rates when reporting them (i.e. 59.94 as 59)
+		switch(frameRate) {
+		case 23: case 29: case 47: case 59: case 119: case 239:
+			return Rate((frameRate + 1) * 1000, 1001);
+		default:
+			return Rate(std::max(frameRate, 0), 1);
+		}
+	}
 
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getMouseButtonCallback()), std::ref(window), fromGLFW(but), fromGLFW(event), fromGLFW(modifiers))
-		);
+	void flushMousePosition() {
+		//Clear the flag before reading, so that newer samples enqueue a new event
+		mousePositionPending.store(false, std::memory_order_release);
+		eventTimestamp = mousePositionTimestamp.load(std::memory_order_relaxed);
+		const auto position = windowState.load().input.getMousePosition();
+		Utils::invokeIf(callbacks.mousePositionCbk, owner.get(), position);
 	}
 
-	static void windowMouseScrollCallback(GLFW::WindowHandle win, double x, double y) {
-		const auto& impl = getUserPointer(win);
-		auto& window = static_cast<Window&>(impl.owner);
-		auto& instance = window.getInstance();
-		
-		instance.addEvent(
-			getEmitterId(impl),
-			std::bind(invokeIf, std::cref(window.getMouseScrollCallback()), std::ref(window), Math::Vec2d(x, y))
+	void flushMouseScroll() {
+		mouseScrollPending.store(false, std::memory_order_release);
+		eventTimestamp = mouseScrollTimestamp.load(std::memory_order_relaxed);
+
+		Math::Vec2d delta;
+		pendingMouseScroll.update(
+			[&delta] (Math::Vec2d& pending) { 
+				delta = pending; 
+				pending = Math::Vec2d(); 
+			}
 		);
+
+		//It might have already been delivered by a previous event
+		if(delta != Math::Vec2d()) {
+			Utils::invokeIf(callbacks.mouseScrollCbk, owner.get(), delta);
+		}
 	}
 
 
@@ -1582,6 +3593,10 @@ void Window::focus() {
 	(*this)->focus();
 }
 
+bool Window::isFocused() const {
+	return (*this)->isFocused();
+}
+
 void Window::setFocusCallback(FocusCallback cbk) {
 	(*this)->setFocusCallback(std::move(cbk));
 }
@@ -1605,6 +3620,159 @@ Window::Monitor Window::getMonitor() const {
 }
 
 
+void Window::setLatencyProfile(LatencyProfile profile) {
+	(*this)->setLatencyProfile(profile);
+}
+
+Window::LatencyProfile Window::getLatencyProfile() const {
+	return (*this)->getLatencyProfile();
+}
+
+size_t Window::getExpectedFrameLatency() const {
+	return (*this)->getExpectedFrameLatency();
+}
+
+
+void Window::setPresentMode(PresentMode mode) {
+	(*this)->setPresentMode(mode);
+}
+
+Window::PresentMode Window::getPresentMode() const {
+	return (*this)->getPresentMode();
+}
+
+std::vector<Window::PresentMode> Window::getPresentModeCompatibility() const {
+	return (*this)->getPresentModeCompatibility();
+}
+
+
+void Window::setMaxFramesInFlight(size_t count) {
+	(*this)->setMaxFramesInFlight(count);
+}
+
+size_t Window::getMaxFramesInFlight() const {
+	return (*this)->getMaxFramesInFlight();
+}
+
+
+void Window::setParallelRecording(bool ena) {
+	(*this)->setParallelRecording(ena);
+}
+
+bool Window::getParallelRecording() const {
+	return (*this)->getParallelRecording();
+}
+
+void Window::setParallelRecording(const LayerBase& layer, bool ena) {
+	(*this)->setParallelRecording(layer, ena);
+}
+
+bool Window::getParallelRecording(const LayerBase& layer) const {
+	return (*this)->getParallelRecording(layer);
+}
+
+
+void Window::setAcquireTimeout(Duration timeout) {
+	(*this)->setAcquireTimeout(timeout);
+}
+
+Duration Window::getAcquireTimeout() const {
+	return (*this)->getAcquireTimeout();
+}
+
+void Window::setAcquirePolicy(AcquirePolicy policy) {
+	(*this)->setAcquirePolicy(policy);
+}
+
+Window::AcquirePolicy Window::getAcquirePolicy() const {
+	return (*this)->getAcquirePolicy();
+}
+
+size_t Window::getSkippedFrameCount() const {
+	return (*this)->getSkippedFrameCount();
+}
+
+size_t Window::getLateFrameCount() const {
+	return (*this)->getLateFrameCount();
+}
+
+void Window::resetFrameCounters() {
+	(*this)->resetFrameCounters();
+}
+
+
+void Window::setFramePacing(bool ena) {
+	(*this)->setFramePacing(ena);
+}
+
+bool Window::getFramePacing() const {
+	return (*this)->getFramePacing();
+}
+
+bool Window::getPresentTimingSupport() const {
+	return (*this)->getPresentTimingSupport();
+}
+
+Duration Window::getRefreshPeriod() const {
+	return (*this)->getRefreshPeriod();
+}
+
+void Window::setPresentTimingCallback(PresentTimingCallback cbk) {
+	(*this)->setPresentTimingCallback(std::move(cbk));
+}
+
+const Window::PresentTimingCallback& Window::getPresentTimingCallback() const {
+	return (*this)->getPresentTimingCallback();
+}
+
+
+void Window::setTimestampQueries(bool ena) {
+	(*this)->setTimestampQueries(ena);
+}
+
+bool Window::getTimestampQueries() const {
+	return (*this)->getTimestampQueries();
+}
+
+Window::GPUTimings Window::getGPUTimings() const {
+	return (*this)->getGPUTimings();
+}
+
+void Window::resetGPUTimings() {
+	(*this)->resetGPUTimings();
+}
+
+
+Window::DurationHistogram Window::getFramePhaseHistogram(FramePhase phase) const {
+	return (*this)->getFramePhaseHistogram(phase);
+}
+
+void Window::resetFramePhaseHistograms() {
+	(*this)->resetFramePhaseHistograms();
+}
+
+
+void Window::setInputLatencyMeasurement(bool ena) {
+	(*this)->setInputLatencyMeasurement(ena);
+}
+
+bool Window::getInputLatencyMeasurement() const {
+	return (*this)->getInputLatencyMeasurement();
+}
+
+Window::DurationHistogram Window::getInputLatencyHistogram() const {
+	return (*this)->getInputLatencyHistogram();
+}
+
+void Window::resetInputLatencyHistogram() {
+	(*this)->resetInputLatencyHistogram();
+}
+
+
+
+Window::InputState Window::getInputState() const {
+	return (*this)->getInputState();
+}
 
 KeyEvent Window::getKeyState(KeyboardKey key) const {
 	return (*this)->getKeyState(key);
@@ -1654,6 +3822,23 @@ const Window::MousePositionCallback& Window::getMousePositionCallback() const {
 }
 
 
+void Window::setRawMouseMotion(bool ena) {
+	(*this)->setRawMouseMotion(ena);
+}
+
+bool Window::getRawMouseMotion() const {
+	return (*this)->getRawMouseMotion();
+}
+
+bool Window::getRawMouseMotionSupport() const {
+	return (*this)->getRawMouseMotionSupport();
+}
+
+Math::Vec2d Window::consumeMouseMotion() {
+	return (*this)->consumeMouseMotion();
+}
+
+
 void Window::setMouseScrollCallback(MouseScrollCallback cbk) {
 	(*this)->setMouseScrollCallback(std::move(cbk));
 }
@@ -1672,12 +3857,34 @@ const Window::CursorEnterCallback& Window::getCursorEnterCallback() const {
 }
 
 
+TimePoint Window::getEventTimestamp() const {
+	return (*this)->getEventTimestamp();
+}
+
+
+void Window::setInputCoalescing(bool ena) {
+	(*this)->setInputCoalescing(ena);
+}
+
+bool Window::getInputCoalescing() const {
+	return (*this)->getInputCoalescing();
+}
+
+uint64_t Window::getCoalescedEventCount() const {
+	return (*this)->getCoalescedEventCount();
+}
+
+uint64_t Window::getEventOverflowCount() const {
+	return (*this)->getEventOverflowCount();
+}
+
+
 
 Window::Monitor Window::getPrimaryMonitor() {
 	return WindowImpl::getPrimaryMonitor();
 }
 
-Utils::BufferView<const Window::Monitor> Window::getMonitors() {
+std::vector<Window::Monitor> Window::getMonitors() {
 	return WindowImpl::getMonitors();
 }
 
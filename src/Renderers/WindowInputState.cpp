@@ -0,0 +1,52 @@
+#include <zuazo/Renderers/Window.h>
+
+#include "../GLFWConversions.h"
+
+#include <limits>
+#include <type_traits>
+
+namespace Zuazo::Renderers {
+
+//Check that all the keys and buttons fit in the bitmasks
+static_assert(static_cast<size_t>(GLFW::KeyboardKey::menu) < Window::InputState::KEY_WORD_COUNT*std::numeric_limits<uint64_t>::digits, "Key bitmask is too small");
+static_assert(std::is_trivially_copyable<Window::InputState>::value, "Input state must be trivially copyable in order to be snapshotted");
+static_assert(static_cast<size_t>(GLFW::MouseButton::nb8) < std::numeric_limits<uint32_t>::digits, "Mouse button bitmask is too small");
+
+static bool testBit(const uint64_t* words, size_t index) noexcept {
+	constexpr size_t WORD_BITS = std::numeric_limits<uint64_t>::digits;
+	return (words[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+
+
+Window::InputState::InputState()
+	: m_keys{}
+	, m_mouseButtons(0)
+	, m_modifiers(KeyModifiers::none)
+	, m_mousePosition()
+{
+}
+
+
+
+KeyEvent Window::InputState::getKeyState(KeyboardKey key) const {
+	const auto index = static_cast<int>(toGLFW(key));
+	const auto pressed = (index >= 0) && testBit(m_keys.data(), static_cast<size_t>(index));
+	return pressed ? KeyEvent::press : KeyEvent::release;
+}
+
+KeyEvent Window::InputState::getMouseButtonState(MouseKey but) const {
+	const auto index = static_cast<int>(toGLFW(but));
+	const auto pressed = (index >= 0) && ((m_mouseButtons >> index) & 1);
+	return pressed ? KeyEvent::press : KeyEvent::release;
+}
+
+KeyModifiers Window::InputState::getKeyModifiers() const {
+	return m_modifiers;
+}
+
+Math::Vec2d Window::InputState::getMousePosition() const {
+	return m_mousePosition;
+}
+
+}
@@ -6,20 +6,29 @@
 namespace Zuazo::Renderers {
 
 //Check compatibility among types
-static_assert(sizeof(void*) == sizeof(GLFW::Monitor), "Sizes must match in order to reinterpret cast");
-static_assert(alignof(void*) == alignof(GLFW::Monitor), "Alignment must match in order to reinterpret cast");
+static_assert(sizeof(Window::Monitor::Mode) == sizeof(GLFW::VideoMode), "Sizes must match in order to reinterpret cast");
+static_assert(alignof(Window::Monitor::Mode) == alignof(GLFW::VideoMode), "Alignment must match in order to reinterpret cast");
 static_assert(offsetof(Window::Monitor::Mode, Window::Monitor::Mode::size) == offsetof(GLFW::VideoMode, GLFW::VideoMode::size), "Size offset does not match");
 static_assert(offsetof(Window::Monitor::Mode, Window::Monitor::Mode::colorDepth) == offsetof(GLFW::VideoMode, GLFW::VideoMode::colorDepth), "Color depth offset does not match");
 static_assert(offsetof(Window::Monitor::Mode, Window::Monitor::Mode::frameRate) == offsetof(GLFW::VideoMode, GLFW::VideoMode::frameRate), "Refresh rate offset does not match");
 
-static GLFW::Monitor reinterpretMonitor(void* handle) {
-	return reinterpret_cast<const GLFW::Monitor&>(handle);
+static const GLFW::MonitorInfo* getInfo(const std::shared_ptr<const void>& info) {
+	//Immutable properties are captured when the monitor is obtained, 
+	//so that querying them never needs to access GLFW
+	return static_cast<const GLFW::MonitorInfo*>(info.get());
+}
+
+static std::shared_ptr<const GLFW::MonitorInfo> getCurrentInfo(const std::shared_ptr<const void>& info) {
+	//Position and current mode may have changed since it was captured. The
+	//registry is kept up to date from the GLFW thread, so just look it up
+	const auto* snapshot = getInfo(info);
+	return snapshot ? GLFW::Monitor::getInfo(snapshot->id) : nullptr;
 }
 
 
 
 Window::Monitor::Monitor()
-	: m_handle(nullptr)
+	: m_info()
 {
 }
 
@@ -32,38 +41,48 @@ Window::Monitor& Window::Monitor::operator=(const Monitor& other) = default;
 
 
 bool Window::Monitor::operator==(const Monitor& other) const noexcept {
-	return m_handle == other.m_handle;
+	const auto* info = getInfo(m_info);
+	const auto* otherInfo = getInfo(other.m_info);
+	return 	(info ? info->id : GLFW::NO_MONITOR_ID) == 
+			(otherInfo ? otherInfo->id : GLFW::NO_MONITOR_ID);
 }
 
 bool Window::Monitor::operator!=(const Monitor& other) const noexcept {
-	return m_handle != other.m_handle;
+	return !operator==(other);
 }
 
 
 
 std::string_view Window::Monitor::getName() const {
-	return reinterpretMonitor(m_handle).getName();
+	const auto* info = getInfo(m_info);
+	return info ? std::string_view(info->name) : std::string_view();
 }
 
 Math::Vec2d Window::Monitor::getPhysicalSize() const {
-	return reinterpretMonitor(m_handle).getPhysicalSize();
+	const auto* info = getInfo(m_info);
+	return info ? info->physicalSize : Math::Vec2i();
 }
 
 Math::Vec2i Window::Monitor::getPosition() const {
-	return reinterpretMonitor(m_handle).getPosition();
+	const auto info = getCurrentInfo(m_info);
+	return info ? info->position : Math::Vec2i();
 }
 
-const Window::Monitor::Mode& Window::Monitor::getMode() const {
-	const auto& vm = reinterpretMonitor(m_handle).getVideoMode();
-	return reinterpret_cast<const Mode&>(vm);
+Window::Monitor::Mode Window::Monitor::getMode() const {
+	const auto info = getCurrentInfo(m_info);
+	return info ? reinterpret_cast<const Mode&>(info->videoMode) : Mode{};
 }
 
 Utils::BufferView<const Window::Monitor::Mode> Window::Monitor::getModes() const {
-	const auto vms = reinterpretMonitor(m_handle).getVideoModes();
-	return Utils::BufferView<const Window::Monitor::Mode>(
-		reinterpret_cast<const Mode*>(vms.data()),
-		vms.size()
-	);
+	const auto* info = getInfo(m_info);
+	if(info) {
+		return Utils::BufferView<const Window::Monitor::Mode>(
+			reinterpret_cast<const Mode*>(info->videoModes.data()),
+			info->videoModes.size()
+		);
+	} else {
+		return Utils::BufferView<const Window::Monitor::Mode>();
+	}
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace Zuazo {
+
+/*
+ * Bounded single producer, single consumer queue. Elements are
+ * copied into preallocated storage, so that neither pushing nor
+ * popping allocates
+ */
+template<typename T, size_t N>
+class RingBuffer {
+	static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+	static_assert((N & (N - 1)) == 0, "Capacity must be a power of 2");
+public:
+	static constexpr size_t CAPACITY = N;
+
+	RingBuffer() noexcept
+		: m_storage()
+		, m_head(0)
+		, m_tail(0)
+	{
+	}
+
+	RingBuffer(const RingBuffer& other) = delete;
+	~RingBuffer() = default;
+
+	RingBuffer& operator=(const RingBuffer& other) = delete;
+
+	//Only from the producer thread
+	bool tryPush(const T& value) noexcept {
+		const auto head = m_head.load(std::memory_order_relaxed);
+		const auto tail = m_tail.load(std::memory_order_acquire);
+
+		if(head - tail == CAPACITY) {
+			return false; //Full
+		}
+
+		m_storage[head & MASK] = value;
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	//Only from the consumer thread
+	bool tryPop(T& value) noexcept {
+		const auto tail = m_tail.load(std::memory_order_relaxed);
+		const auto head = m_head.load(std::memory_order_acquire);
+
+		if(head == tail) {
+			return false; //Empty
+		}
+
+		value = m_storage[tail & MASK];
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	static constexpr size_t MASK = CAPACITY - 1;
+
+	std::array<T, CAPACITY>								m_storage;
+	alignas(64) std::atomic<size_t>						m_head;
+	alignas(64) std::atomic<size_t>						m_tail;
+
+};
+
+}
@@ -0,0 +1,136 @@
+#include "WorkerPool.h"
+
+#include <utility>
+#include <cassert>
+
+namespace Zuazo {
+
+WorkerPool::WorkerPool(size_t threadCount)
+	: m_threads()
+	, m_executeMutex()
+	, m_mutex()
+	, m_jobCondition()
+	, m_doneCondition()
+	, m_job(nullptr)
+	, m_jobCount(0)
+	, m_nextIndex(0)
+	, m_generation(0)
+	, m_busyThreadCount(0)
+	, m_exception()
+	, m_exit(false)
+{
+	m_threads.reserve(threadCount);
+	for(size_t i = 0; i < threadCount; ++i) {
+		m_threads.emplace_back(&WorkerPool::threadFunc, this);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	//Raise the exit flag and signal it to the threads
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_exit = true;
+	m_jobCondition.notify_all();
+	lock.unlock();
+
+	//Wait thread finalization
+	for(auto& thread : m_threads) {
+		assert(thread.joinable());
+		thread.join();
+	}
+}
+
+
+
+size_t WorkerPool::getConcurrency() const noexcept {
+	return m_threads.size() + 1; //Caller also participates
+}
+
+void WorkerPool::parallelFor(size_t count, const Job& job) {
+	if(count <= 1 || m_threads.empty()) {
+		//Not worth waking up the threads
+		for(size_t i = 0; i < count; ++i) {
+			job(i);
+		}
+	} else {
+		//Only a job can be run at a time
+		std::lock_guard<std::mutex> executeLock(m_executeMutex);
+
+		//Publish the job and signal it to the threads
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_job = &job;
+		m_jobCount = count;
+		m_nextIndex.store(0, std::memory_order_relaxed);
+		m_busyThreadCount = m_threads.size();
+		++m_generation;
+		m_jobCondition.notify_all();
+		lock.unlock();
+
+		//Contribute from this thread
+		work();
+
+		//Wait until all threads have finished
+		lock.lock();
+		m_doneCondition.wait(lock, [this] { return m_busyThreadCount == 0; });
+		m_job = nullptr;
+		const auto exception = std::exchange(m_exception, nullptr);
+		lock.unlock();
+
+		if(exception) {
+			std::rethrow_exception(exception);
+		}
+	}
+}
+
+
+
+size_t WorkerPool::getDefaultThreadCount() noexcept {
+	const size_t concurrency = std::thread::hardware_concurrency();
+	return concurrency > 1 ? concurrency - 1 : 0; //Caller also participates
+}
+
+
+
+void WorkerPool::threadFunc() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	size_t generation = 0;
+
+	while(true) {
+		//Wait until a new job is published
+		m_jobCondition.wait(lock, [this, generation] { return m_exit || m_generation != generation; });
+		if(m_exit) {
+			break;
+		}
+
+		generation = m_generation;
+
+		//Execute it unlocked
+		lock.unlock();
+		work();
+		lock.lock();
+
+		//Signal completion
+		assert(m_busyThreadCount > 0);
+		if(--m_busyThreadCount == 0) {
+			m_doneCondition.notify_all();
+		}
+	}
+}
+
+void WorkerPool::work() {
+	assert(m_job);
+
+	size_t index;
+	while((index = m_nextIndex.fetch_add(1, std::memory_order_relaxed)) < m_jobCount) {
+		try {
+			(*m_job)(index);
+		} catch(...) {
+			//Keep the first exception to rethrow it on the caller
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if(!m_exception) {
+				m_exception = std::current_exception();
+			}
+		}
+	}
+}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <exception>
+
+namespace Zuazo {
+
+class WorkerPool {
+public:
+	using Job = std::function<void(size_t)>;
+
+	explicit WorkerPool(size_t threadCount = getDefaultThreadCount());
+	WorkerPool(const WorkerPool& other) = delete;
+	~WorkerPool();
+
+	WorkerPool&							operator=(const WorkerPool& other) = delete;
+
+	size_t								getConcurrency() const noexcept;
+	void								parallelFor(size_t count, const Job& job);
+
+	static size_t						getDefaultThreadCount() noexcept;
+
+private:
+	std::vector<std::thread>			m_threads;
+	std::mutex							m_executeMutex;
+	std::mutex							m_mutex;
+	std::condition_variable				m_jobCondition;
+	std::condition_variable				m_doneCondition;
+
+	const Job*							m_job;
+	size_t								m_jobCount;
+	std::atomic<size_t>					m_nextIndex;
+	size_t								m_generation;
+	size_t								m_busyThreadCount;
+	std::exception_ptr					m_exception;
+	bool								m_exit;
+
+	void								threadFunc();
+	void								work();
+
+};
+
+}